@@ -0,0 +1,99 @@
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "settings.h"
+#include "font.h"
+#include "matrix_layout.h"
+
+typedef MatrixLayout<PANEL_WIDTH, PANEL_HEIGHT, PANEL_COUNT, PANEL_ORDER, PANEL_ROTATION> Matrix;
+static_assert(Matrix::LED_COUNT == NUM_LEDS, "NUM_LEDS does not match the panel layout");
+
+extern CRGB leds[NUM_LEDS];
+
+// LED index for every (x, y), generated at compile time from the layout
+static constexpr const uint16_t (&xyTable)[MATRIX_WIDTH][MATRIX_HEIGHT] = Matrix::table.index;
+
+// Register the LED outputs with FastLED: one pin for the whole chain, or
+// one per panel when PANEL_PARALLEL so a wider wall refreshes just as fast
+void addLedControllers();
+
+// Helper function to convert x,y coordinates to LED index
+inline uint16_t XY(uint8_t x, uint8_t y) { return xyTable[x][y]; }
+
+// Function to set a pixel in the matrix
+void setMatrixPixel(int x, int y, CRGB color);
+
+// Function to test the display
+void testDisplay();
+
+void updateDisplay();
+
+// Push leds[] to the strip unless it matches the last pushed frame (a show()
+// costs ~7.7 ms for 256 pixels). Brightness comes from powerManager, per
+// frame. With LED_ASYNC_OUTPUT the frame is copied to the front buffer and
+// sent by the output task, so this only waits if the previous frame is still
+// going out. Returns true if the frame was sent.
+bool showFrame(bool force = false);
+
+// Non-blocking scroller: advances the message by one column per frame
+// period, so loop() stays free for WiFi, fetches and serial work between frames.
+// Messages that fit the matrix are shown centered and held instead of scrolled.
+class Scroller {
+public:
+    // Start scrolling a new message from the right edge
+    void start(const char* message, CRGB color);
+
+    // Same for text that is already rasterized (one byte per column)
+    void startColumns(const uint8_t* strip, int width, CRGB color);
+
+    // Show a message once the current pass has finished
+    void queue(const char* message, CRGB color);
+
+    // Draw the next frame if it is due. Returns true when a frame was drawn.
+    bool tick(unsigned long now);
+
+    // When tick() next has something to do: the next column, or the end of a hold
+    unsigned long nextFrameAt() const { return lastFrameTime + (isStatic ? holdTime : framePeriod); }
+
+    // True when the message has scrolled off and nothing is queued
+    bool isIdle() const { return done && !hasPending; }
+
+    void setFramePeriod(unsigned long ms) { framePeriod = ms; }
+
+    // Push at most this many frames per second; scroll speed is unchanged,
+    // columns in between are skipped. 0 disables the cap.
+    void setMaxFps(unsigned int fps) { minShowInterval = fps ? 1000 / fps : 0; }
+
+    // Hold time for static messages; 0 scrolls every message
+    void setStaticHold(unsigned long ms) { holdTime = ms; }
+
+private:
+    void begin(CRGB color);
+    void renderFrame();
+    bool drawFrame();
+
+    uint8_t columns[MAX_MESSAGE_LENGTH * CHAR_COLUMNS];
+    CRGB textColor;
+    int totalWidth = 0;
+    int xStart = 0;
+    char pendingText[100];
+    CRGB pendingColor;
+    bool hasPending = false;
+    bool done = true;
+    unsigned long framePeriod = SCROLL_FRAME_MS;
+    unsigned long lastFrameTime = 0;
+    unsigned long minShowInterval = MAX_FPS ? 1000 / MAX_FPS : 0;
+    unsigned long lastShowTime = 0;
+    bool isStatic = false;        // Current message fits and is held, not scrolled
+    bool staticDrawn = false;
+    unsigned long holdTime = STATIC_HOLD_MS;
+};
+
+extern Scroller scroller;
+
+// Scroll a message to completion. Blocks, so not for use from loop().
+void scrollMessage(const char* message, CRGB color);
+
+#endif // DISPLAY_H
@@ -0,0 +1,51 @@
+#ifndef FETCH_H
+#define FETCH_H
+
+#include <Arduino.h>
+#include "snapshot.h"
+#include "history.h"
+
+extern bool initialFetchDone;  // Flag to track initial fetch
+
+// Readings being filled by the network task (only touched on core 0)
+extern SensorSnapshot netReadings;
+
+// Upstream time of the newest reading seen per source, as sent by the API
+// (sensor.community "timestamp", OpenMeteo "current.time")
+extern char lastPMTimestamp[20];
+extern char lastTempTimestamp[20];
+extern char lastWeatherTime[20];
+
+// Last 24 h of each sensor, fed by fetchSensorData()
+extern History pmHistory;
+extern History temperatureHistory;
+
+enum FetchResult {
+    FETCH_ERROR,
+    FETCH_UNCHANGED,    // Reply fine, but upstream has nothing newer
+    FETCH_UPDATED       // New values stored in netReadings
+};
+
+// Function to fetch sensor data
+FetchResult fetchSensorData(const char* sensorId, bool isPMSensor);
+
+// Fetch PM2.5 from all PM_SENSOR_IDS at once and store the fused value
+FetchResult fetchPMData();
+
+// Same from the sensor.community area feed (PM_AREA_MODE). The reply is
+// parsed one record at a time, so memory use doesn't grow with its size.
+FetchResult fetchAreaData();
+
+// Median of the values after dropping outliers (more than 3 scaled MADs,
+// and at least PM_OUTLIER_MIN, from the median). Sorts values in place and
+// returns how many were used. For up to 8 values.
+int fuseReadings(float* values, int count, float& result);
+
+// Function to fetch weather data from OpenMeteo
+FetchResult fetchWeatherData();
+
+// Function to convert UTC timestamp to Thailand time (UTC+7). Writes
+// netReadings.localTime and returns it.
+const char* adjustToLocalTime(const char* timestamp);
+
+#endif // FETCH_H
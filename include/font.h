@@ -0,0 +1,23 @@
+#ifndef FONT_H
+#define FONT_H
+
+#include <Arduino.h>
+
+#define CHAR_COLUMNS 6           // Widest advance per byte of text: 5 pixel glyph + 1 column spacing
+
+// Symbols outside ASCII, as UTF-8
+#define GLYPH_DEGREE "\xC2\xB0"          // U+00B0
+#define GLYPH_MICRO "\xC2\xB5"           // U+00B5
+#define GLYPH_CUBED "\xC2\xB3"           // U+00B3
+#define GLYPH_ARROW_UP "\xE2\x86\x91"    // U+2191
+#define GLYPH_ARROW_DOWN "\xE2\x86\x93"  // U+2193
+#define GLYPH_ARROW_RIGHT "\xE2\x86\x92" // U+2192
+
+// Rasterize UTF-8 text into one column byte per pixel column (bit y = row y)
+// from the proportional glyph atlas: ASCII, degree/micro/superscripts,
+// arrows and Thai. Thai vowel and tone marks are drawn over the consonant
+// before them. Characters without a glyph stay blank. Returns the number
+// of columns written; text that doesn't fit is cut at a character.
+int rasterizeText(const char* text, uint8_t* columns, int maxColumns);
+
+#endif // FONT_H
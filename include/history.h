@@ -0,0 +1,91 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <Arduino.h>
+
+#define HISTORY_SLOT_SECONDS 600    // One averaged value per 10 minutes
+#define HISTORY_SLOTS 144           // 24 hours
+#define HISTORY_SHORT_SLOTS 6       // 1 hour
+#define HISTORY_NO_DATA INT16_MIN   // Slot without readings
+#define HISTORY_SPARKLINE_MAX 48    // Widest sparkline(), three slots per column
+
+// Min/max/mean over the newest LENGTH slots of a history ring. The mean is
+// a running sum; min and max are monotonic deques of ring positions, so
+// each new slot costs amortized O(1) whatever the window length.
+template <uint8_t LENGTH>
+class RollingWindow {
+public:
+    // Forget the slot falling out of the window. Called before position is
+    // overwritten, while ring still holds the outgoing value.
+    void expire(const int16_t* ring, uint8_t position);
+    // Take in the value just written at position
+    void add(const int16_t* ring, uint8_t position);
+
+    uint8_t count() const { return samples; }
+    int32_t sum() const { return total; }
+    int16_t min(const int16_t* ring) const { return minSize ? ring[minQueue[minFront]] : HISTORY_NO_DATA; }
+    int16_t max(const int16_t* ring) const { return maxSize ? ring[maxQueue[maxFront]] : HISTORY_NO_DATA; }
+
+private:
+    static uint8_t outgoing(uint8_t position) { return (position + HISTORY_SLOTS - LENGTH) % HISTORY_SLOTS; }
+
+    uint8_t minQueue[LENGTH];      // Ring positions, values rising front to back
+    uint8_t maxQueue[LENGTH];      // Ring positions, values falling front to back
+    uint8_t minFront = 0, minSize = 0;
+    uint8_t maxFront = 0, maxSize = 0;
+    uint8_t samples = 0;
+    int32_t total = 0;
+};
+
+struct HistoryStats {
+    int16_t mean = HISTORY_NO_DATA;    // Fixed point, same scale as record()
+    int16_t min = HISTORY_NO_DATA;
+    int16_t max = HISTORY_NO_DATA;
+};
+
+// 24 hours of one sensor in fixed point (value x 10), one slot per
+// HISTORY_SLOT_SECONDS. Readings within a slot are averaged; the slot is
+// committed to the ring and the rolling windows when the next one starts.
+// 628 bytes per sensor, all static.
+class History {
+public:
+    History();
+
+    // Add a reading taken at timestamp (seconds, any epoch). Older slots are
+    // ignored, and so is timestamp 0 (unparsed).
+    void record(uint32_t timestamp, int16_t value);
+
+    // Last hour and last 24 hours, each including the slot in progress
+    HistoryStats shortWindow() const;
+    HistoryStats longWindow() const;
+
+    // Newest value: the average of the slot in progress, else the last slot
+    int16_t latest() const;
+
+    // -1 falling, 0 steady, 1 rising: latest against the 1 h mean
+    int8_t trend(int16_t threshold) const;
+
+    // Hourly means of the last 24 h as bar heights 1-height (0 = no data),
+    // scaled between their min and max, oldest first. At most
+    // HISTORY_SPARKLINE_MAX columns; any beyond are left at 0.
+    void sparkline(uint8_t* heights, uint8_t columns, uint8_t height) const;
+
+private:
+    void commit(int16_t value);
+    template <uint8_t LENGTH>
+    HistoryStats window(const RollingWindow<LENGTH>& w) const;
+
+    int16_t ring[HISTORY_SLOTS];
+    uint8_t head = HISTORY_SLOTS - 1;   // Position of the newest committed slot
+    RollingWindow<HISTORY_SHORT_SLOTS> hour;
+    RollingWindow<HISTORY_SLOTS> day;
+
+    uint32_t openSlot = 0;              // Slot in progress, 0 = none yet
+    int32_t pendingSum = 0;
+    uint8_t pendingCount = 0;
+};
+
+// Fixed point conversion of an API value string ("12.35" -> 124)
+int16_t toFixedPoint(const char* value);
+
+#endif // HISTORY_H
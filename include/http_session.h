@@ -0,0 +1,97 @@
+#ifndef HTTP_SESSION_H
+#define HTTP_SESSION_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <HTTPClient.h>  // HTTPC_ERROR_* codes
+#include "inflate_stream.h"
+
+#define HTTP_DNS_TTL 300000      // Re-resolve the host after 5 minutes
+#define HTTP_DRAIN_LIMIT 4096    // Drain up to this many unread bytes to keep the connection
+
+// Response body of an HttpSession: stops at Content-Length and removes
+// chunked transfer encoding, so a parser can read it like a plain stream.
+class HttpBodyStream : public Stream {
+public:
+    void reset(WiFiClient* client, long contentLength, bool chunked, unsigned long timeout);
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t) override { return 0; }
+
+    // True once the whole body has been read
+    bool finished() const { return done; }
+
+private:
+    bool ensureData();
+    bool readChunkHeader();
+    int readRaw();
+
+    WiFiClient* client = nullptr;
+    long remaining = 0;          // Bytes left in the body or current chunk, -1 = until close
+    bool chunked = false;
+    bool done = true;
+    unsigned long timeoutMs = 0;
+};
+
+// Persistent HTTP/1.1 client for one host. Keeps the connection alive
+// between requests and caches the resolved address, so back-to-back
+// requests skip the DNS lookup and TCP handshake.
+class HttpSession {
+public:
+    HttpSession(const char* host, uint16_t port = 80) : host(host), port(port) {}
+
+    // Send a GET request and read the response headers. Returns the HTTP
+    // status code, or a negative HTTPC_ERROR_* code.
+    int get(const char* path);
+
+    // get() in two halves, so requests to several servers can be in flight
+    // at once: send() connects and writes the request without waiting for
+    // the reply (0 or a negative HTTPC_ERROR_* code), receive() then reads
+    // the response headers. path must stay valid until receive() returns.
+    int send(const char* path);
+    int receive();
+
+    // Body of the last response, inflated if the server compressed it
+    Stream& body();
+
+    // Finish the current response. A small unread remainder is drained so
+    // the connection can be reused; otherwise the connection is closed.
+    void end();
+
+    // Drop the connection (the cached address is kept)
+    void close();
+
+    void setTimeout(unsigned long ms) { timeoutMs = ms; }
+
+    // Ask for gzip/deflate replies (on by default); body() inflates them
+    void setCompression(bool enabled) { compression = enabled; }
+
+    // True if the last request went over an already open connection
+    bool reusedConnection() const { return reused; }
+
+private:
+    bool connect();
+    bool sendRequest(const char* path);
+    int readResponseHead();
+    bool readLine(char* buffer, size_t size);
+
+    const char* host;
+    uint16_t port;
+    const char* pendingPath = nullptr;  // Request to repeat if a reused connection was stale
+    WiFiClient client;
+    HttpBodyStream bodyStream;
+    InflateStream inflater;
+    ContentEncoding encoding = ENCODING_IDENTITY;
+    bool compression = true;
+    IPAddress address;
+    unsigned long resolvedAt = 0;
+    bool resolved = false;
+    bool keepAlive = false;
+    bool reused = false;
+    long contentLength = -1;
+    unsigned long timeoutMs = 10000;
+};
+
+#endif // HTTP_SESSION_H
@@ -0,0 +1,60 @@
+#ifndef INFLATE_STREAM_H
+#define INFLATE_STREAM_H
+
+#include <Arduino.h>
+
+class HttpBodyStream;
+
+#define INFLATE_INPUT_SIZE 256  // Compressed bytes taken from the socket per step
+
+enum ContentEncoding {
+    ENCODING_IDENTITY,
+    ENCODING_GZIP,
+    ENCODING_DEFLATE,
+    ENCODING_UNSUPPORTED
+};
+
+// Decompresses a gzip or deflate response body while it is being read,
+// using the tinfl inflater from the ESP32 ROM. Output goes through the
+// 32 KB deflate window, so a parser sees a plain stream and the whole body
+// is never held in memory. The inflater state and window are one static
+// block shared by all streams: only one compressed body can be read at a
+// time, a second begin() fails until end().
+class InflateStream : public Stream {
+public:
+    // Start on a new body. Returns false if another stream holds the inflater.
+    bool begin(HttpBodyStream* source, ContentEncoding encoding, unsigned long timeout);
+    // Release the inflater; the rest of the source is left unread
+    void end();
+
+    bool active() const { return owner; }
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t) override { return 0; }
+
+private:
+    bool refill();
+    bool fillInput();
+    int nextInput();
+    bool skipGzipHeader();
+    bool start();
+
+    HttpBodyStream* source = nullptr;
+    ContentEncoding encoding = ENCODING_IDENTITY;
+    unsigned long timeoutMs = 0;
+    bool owner = false;
+    bool started = false;
+    bool failed = false;
+    bool zlibWrapped = false;
+    int status = 0;              // Last tinfl_status
+    uint8_t input[INFLATE_INPUT_SIZE];
+    size_t inputPos = 0;
+    size_t inputLength = 0;
+    size_t outputPos = 0;        // Unread output is window[outputPos, outputEnd)
+    size_t outputEnd = 0;
+    size_t windowPos = 0;        // Where the next output goes
+};
+
+#endif // INFLATE_STREAM_H
@@ -0,0 +1,23 @@
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+#include <ArduinoJson.h>
+#include "settings.h"
+
+#define JSON_ARENA_SIZE SENSOR_DOC_SIZE  // Largest document parsed
+static_assert(JSON_ARENA_SIZE >= WEATHER_DOC_SIZE, "JSON arena too small for the weather reply");
+
+// ArduinoJson allocator backed by one static block instead of the heap.
+// Documents are only parsed on the network task, one at a time, so a
+// single block is enough; a second live document gets no memory (the parse
+// fails with NoMemory) rather than falling back to malloc().
+struct JsonArenaAllocator {
+    void* allocate(size_t size);
+    void deallocate(void* pointer);
+    void* reallocate(void* pointer, size_t size);
+};
+
+// Parsed reply of one request: ArenaJsonDocument doc(SENSOR_DOC_SIZE);
+typedef BasicJsonDocument<JsonArenaAllocator> ArenaJsonDocument;
+
+#endif // JSON_ARENA_H
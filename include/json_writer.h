@@ -0,0 +1,56 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <Arduino.h>
+#include <stdarg.h>
+#include "history.h"
+
+// Appends formatted JSON to a fixed buffer; output past the end is dropped
+// and reported through overflow() instead of being sent half-written
+class JsonWriter {
+public:
+    JsonWriter(char* out, size_t size) : out(out), size(size) { out[0] = '\0'; }
+
+    void printf(const char* format, ...) {
+        if (length >= size) return;
+        va_list args;
+        va_start(args, format);
+        int n = vsnprintf(out + length, size - length, format, args);
+        va_end(args);
+        length += n > 0 ? n : 0;
+    }
+
+    // Fixed point x10 from the history, null when there is no data yet
+    void tenths(const char* key, int16_t value) {
+        if (value == HISTORY_NO_DATA) printf("\"%s\":null,", key);
+        else printf("\"%s\":%.1f,", key, value / 10.0f);
+    }
+
+    // Sensor.Community values arrive as text; empty until the first fetch
+    void reading(const char* key, const char* value) {
+        if (value[0] == '\0') printf("\"%s\":null,", key);
+        else printf("\"%s\":%.2f,", key, atof(value));
+    }
+
+    // Seconds since a millis() stamp, null if it wasn't set since boot
+    void age(const char* key, uint32_t since, unsigned long now) {
+        if (since == 0) printf("\"%s\":null,", key);
+        else printf("\"%s\":%lu,", key, (unsigned long)((now - since) / 1000));
+    }
+
+    // Drop the trailing comma before closing an object
+    void close(char bracket) {
+        if (length > 0 && length < size && out[length - 1] == ',') length--;
+        printf("%c", bracket);
+    }
+
+    bool overflow() const { return length >= size; }
+    size_t written() const { return length; }
+
+private:
+    char* out;
+    size_t size;
+    size_t length = 0;
+};
+
+#endif // JSON_WRITER_H
@@ -0,0 +1,116 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "settings.h"
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+#define LOG_LINE_SIZE 384       // Longer lines are cut; the telemetry summary reaches ~300
+#define LOG_REPORT_SIZE 2048    // Multi-line reports (LogReport); the telemetry report is ~1.5 KB
+
+// One line each, printf style. Levels above LOG_LEVEL are removed at compile
+// time, arguments included.
+#define LOG_AT(level, ...) do { if (LOG_LEVEL >= (level)) logger.printf(__VA_ARGS__); } while (0)
+#define LOG_ERROR(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_WARN(...) LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_DEBUG(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+// Serial output without blocking the caller. Lines are formatted straight
+// into a ring of LOG_QUEUE_LINES fixed slots; any task can add one (a slot
+// is claimed with a compare-and-swap, no lock) and a low-priority task
+// writes them out. When the ring is full the line is counted and dropped,
+// so a host that stops reading USB-CDC never stalls a frame or a fetch.
+// The host build writes each line out as soon as it is complete.
+class Logger {
+public:
+    // Start the output task on the device
+    void begin(Print& out);
+
+    void printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+    // Write every complete line to the output; called by the output task
+    void drain();
+
+    uint32_t dropped() const { return droppedLines.load(std::memory_order_relaxed); }
+
+private:
+    friend class LogLine;
+    friend class LogReport;
+
+    enum ReportState : uint8_t { REPORT_FREE, REPORT_WRITING, REPORT_READY };
+
+    struct Slot {
+        std::atomic<bool> ready{false};  // Written and not yet sent
+        uint16_t length;
+        char text[LOG_LINE_SIZE];
+    };
+
+    Slot* reserve();
+    void commit(Slot* slot);
+    void writeReport();
+
+    Print* output = &Serial;
+    bool outputTask = false;
+    Slot slots[LOG_QUEUE_LINES];
+    std::atomic<uint32_t> head{0};       // Next slot to claim
+    std::atomic<uint32_t> tail{0};       // Next slot to send, moved by drain() only
+    std::atomic<uint32_t> droppedLines{0};
+    std::atomic<bool> draining{false};
+    uint32_t reportedDrops = 0;
+
+    // One report at a time, sent when the lines claimed before it are out
+    char reportText[LOG_REPORT_SIZE];
+    size_t reportLength = 0;
+    uint32_t reportAfter = 0;            // head when the report was finished
+    std::atomic<uint8_t> reportState{REPORT_FREE};
+};
+
+extern Logger logger;
+
+// A Print that collects one line for the logger, for code that prints a
+// line in pieces (e.g. Telemetry::printSummary). Sent when it goes out of
+// scope; a newline ends it early.
+class LogLine : public Print {
+public:
+    LogLine() : slot(logger.reserve()) {}
+    ~LogLine() { if (slot) logger.commit(slot); }
+    LogLine(const LogLine&) = delete;
+    LogLine& operator=(const LogLine&) = delete;
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+
+private:
+    Logger::Slot* slot;
+    bool ended = false;
+};
+
+// A Print that collects a multi-line reply (e.g. the "stats" report) in
+// the logger's report buffer, so it goes out through the output task
+// instead of blocking the caller on Serial. Sent when it goes out of
+// scope; while an earlier report is still waiting, the new one is dropped
+// and counted. Longer text than LOG_REPORT_SIZE is cut.
+class LogReport : public Print {
+public:
+    LogReport();
+    ~LogReport();
+    LogReport(const LogReport&) = delete;
+    LogReport& operator=(const LogReport&) = delete;
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+
+private:
+    bool active = false;
+};
+
+#endif // LOGGER_H
@@ -0,0 +1,57 @@
+#ifndef MATRIX_LAYOUT_H
+#define MATRIX_LAYOUT_H
+
+#include <stdint.h>
+
+// How the strip runs through the columns of one panel
+enum ColumnOrder {
+    SERPENTINE_EVEN_FORWARD,   // Even columns run from row 0 down, odd columns back up
+    SERPENTINE_ODD_FORWARD,    // The other way round
+    PROGRESSIVE                // Every column starts at row 0
+};
+
+// Mounting of the whole wall. Only 0 and 180 degrees, since the text
+// always runs along the long side.
+enum MatrixRotation {
+    ROTATE_0,
+    ROTATE_180                 // Upside down: data input on the right
+};
+
+// Geometry of Panels column-wired panels of PanelWidth x Height, chained
+// left to right. The LED index of every pixel is worked out at compile
+// time, so drawing is one table lookup with no branches per pixel.
+template <uint16_t PanelWidth, uint8_t Height, uint8_t Panels, ColumnOrder Order, MatrixRotation Rotation>
+struct MatrixLayout {
+    static constexpr uint16_t WIDTH = PanelWidth * Panels;
+    static constexpr uint16_t PANEL_LEDS = PanelWidth * Height;
+    static constexpr uint16_t LED_COUNT = PANEL_LEDS * Panels;
+
+    // LED index for pixel (x, y), with (0, 0) at the top left as seen
+    static constexpr uint16_t index(uint16_t x, uint8_t y) {
+        uint16_t px = Rotation == ROTATE_180 ? WIDTH - 1 - x : x;
+        uint8_t py = Rotation == ROTATE_180 ? Height - 1 - y : y;
+        uint16_t panel = px / PanelWidth;
+        uint16_t column = px % PanelWidth;
+        bool forward = Order == PROGRESSIVE ||
+                       (column % 2 == 0) == (Order == SERPENTINE_EVEN_FORWARD);
+        return panel * PANEL_LEDS + column * Height + (forward ? py : Height - 1 - py);
+    }
+
+    struct Table {
+        uint16_t index[WIDTH][Height];
+    };
+
+    static constexpr Table makeTable() {
+        Table table = {};
+        for (uint16_t x = 0; x < WIDTH; x++) {
+            for (uint8_t y = 0; y < Height; y++) {
+                table.index[x][y] = index(x, y);
+            }
+        }
+        return table;
+    }
+
+    static constexpr Table table = makeTable();
+};
+
+#endif // MATRIX_LAYOUT_H
@@ -0,0 +1,90 @@
+#ifndef MQTT_PUBLISHER_H
+#define MQTT_PUBLISHER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include "settings.h"
+#include "snapshot.h"
+
+#define MQTT_PAYLOAD_SIZE 384
+#define MQTT_ACK_TIMEOUT 3000       // Wait for CONNACK / PUBACK
+#define MQTT_RETRY_INTERVAL 60000   // After a failed flush, unless a fetch wakes the radio first
+#define MQTT_KEEPALIVE 60           // Seconds; a session only lasts one flush
+
+struct MqttStats {
+    uint32_t published = 0;         // Batches acknowledged by the broker
+    uint32_t dropped = 0;           // Oldest batches overwritten while the queue was full
+    uint32_t failures = 0;          // Flushes that could not connect or lost the connection
+    uint8_t queued = 0;             // Batches waiting when the copy was taken
+};
+
+// Batched telemetry to an MQTT 3.1.1 broker. update() samples the readings,
+// fetch counters and frame/heap metrics into a bounded queue every interval
+// and flushes the queue right after a fetch, while the radio is awake
+// anyway, or once a batch has waited MQTT_FLUSH_DELAY. A flush is one short
+// session: CONNECT, every batch as a QoS 1 PUBLISH that leaves the queue on
+// its PUBACK, DISCONNECT. While the broker or WiFi is down the newest
+// MQTT_QUEUE_SIZE batches are kept. Runs on the network task only, so the
+// renderer never waits for it. Other tasks read the counters through
+// stats(), a copy taken under a spinlock.
+class MqttPublisher {
+public:
+    // An empty host disables publishing; user may be null
+    void begin(const char* host, uint16_t port, const char* user = nullptr, const char* password = nullptr);
+
+    // Call after every network task pass; fetched is true if it fetched
+    void update(const SensorSnapshot& readings, unsigned long now, bool fetched);
+
+    // Queue a batch now
+    void sample(const SensorSnapshot& readings, unsigned long now);
+    // Publish everything queued. Returns true if the queue is empty afterwards.
+    bool flush();
+
+    // 0 takes a sample after every fetch
+    void setInterval(unsigned long ms) { interval = ms; }
+
+    bool enabled() const { return host != nullptr && host[0] != '\0'; }
+    MqttStats stats() const;
+    const char* topic() const { return topicName; }
+
+private:
+    struct Batch {
+        unsigned long takenAt;
+        uint16_t length;
+        char payload[MQTT_PAYLOAD_SIZE];
+    };
+
+    bool connect();
+    bool publish(const Batch& batch);
+    void countFailure();
+    bool send(size_t length);
+    bool readAck(uint8_t type, uint8_t* body);
+    size_t putString(size_t at, const char* text);
+
+    const char* host = nullptr;
+    uint16_t port = MQTT_PORT;
+    const char* user = nullptr;
+    const char* password = nullptr;
+    char clientId[16];
+    char topicName[64];
+    WiFiClient client;
+
+    Batch queue[MQTT_QUEUE_SIZE];
+    uint8_t head = 0;               // Oldest batch
+    uint8_t count = 0;
+    unsigned long interval = MQTT_INTERVAL;
+    unsigned long lastSample = 0;
+    unsigned long retryAt = 0;
+    bool retryPending = false;
+    uint16_t packetId = 0;
+    uint8_t packet[MQTT_PAYLOAD_SIZE + 96];  // Fixed header, topic and payload of one message
+    MqttStats counters;             // queued is filled in by stats()
+    mutable SpinLock statsLock;     // Around count, head and counters
+};
+
+extern MqttPublisher mqttPublisher;
+
+// The compact JSON of one batch. Returns its length, or 0 if it did not fit.
+size_t buildTelemetryPayload(const SensorSnapshot& readings, unsigned long now, char* out, size_t size);
+
+#endif // MQTT_PUBLISHER_H
@@ -0,0 +1,57 @@
+#ifndef POLL_SCHEDULER_H
+#define POLL_SCHEDULER_H
+
+#include <Arduino.h>
+#include "fetch.h"
+#include "telemetry.h"  // FetchSource
+
+#define POLL_SPACING 2000            // Minimum gap between two fetches of any source
+#define POLL_RECHECK_DIVISOR 8       // After an unchanged reply, look again after cadence / 8,
+                                     // doubling while upstream stays silent
+#define POLL_ERROR_BACKOFF 10000     // First retry delay after an error, doubled per error
+
+// Upstream timestamp ("2025-02-16 03:11:56" or "2025-02-16T10:15") in
+// seconds since 2000-01-01, or 0 if it can't be parsed. Only differences
+// between two values of the same source are meaningful.
+uint32_t parseTimestamp(const char* timestamp);
+
+// Decides when each source is fetched next. Every source learns how often
+// its upstream actually publishes from the timestamps it returns and polls
+// just after the next reading is expected; unchanged replies are rechecked
+// sooner, errors back off exponentially. At most one source is due at a
+// time, so fetches never pile up in the same pass.
+class PollScheduler {
+public:
+    // cadence is the expected upstream period; learning stays within the limits
+    void configure(FetchSource source, unsigned long cadence, unsigned long minInterval,
+                   unsigned long maxInterval);
+
+    // Source to fetch now, or -1 if none is due
+    int nextDue(unsigned long now);
+
+    // Report the outcome of a fetch of source, with the upstream timestamp
+    // of the newest reading (0 if unknown)
+    void complete(int source, FetchResult result, uint32_t upstreamTime, unsigned long now);
+
+    unsigned long cadence(int source) const { return sources[source].cadence; }
+
+private:
+    struct Source {
+        unsigned long cadence = 0;         // Learned upstream period
+        unsigned long minInterval = 0;
+        unsigned long maxInterval = 0;
+        unsigned long dueAt = 0;
+        uint32_t lastUpstream = 0;
+        uint8_t errors = 0;
+        uint8_t misses = 0;                // Unchanged replies since the last new reading
+        bool active = false;
+    };
+
+    void schedule(Source& s, unsigned long now, unsigned long delay);
+
+    Source sources[SOURCE_COUNT];
+    unsigned long lastFetch = 0;
+    bool fetched = false;
+};
+
+#endif // POLL_SCHEDULER_H
@@ -0,0 +1,49 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "settings.h"
+#include "snapshot.h"
+
+// WS2812B draw per channel at full drive, and of a dark LED, in mA
+#define LED_RED_MA 16
+#define LED_GREEN_MA 11
+#define LED_BLUE_MA 15
+#define LED_IDLE_MA 1
+
+// Minutes since local midnight, advanced from the time of the newest PM
+// reading; -1 while there is none from this boot
+int localMinuteOfDay(const SensorSnapshot& readings, unsigned long now);
+
+// Chooses the brightness of every frame: the day or night level from the
+// schedule, lowered as far as needed to keep the frame inside the current
+// budget. Brightness scales all channels alike, so colours never clip.
+class PowerManager {
+public:
+    void setBudget(uint32_t milliamps) { budget = milliamps; }
+    void setSchedule(uint8_t dayLevel, uint8_t nightLevel, uint8_t nightStartHour, uint8_t nightEndHour);
+
+    // Time of day for the schedule, -1 if unknown (then the day level is used)
+    void setClock(int minuteOfDay) { clock = minuteOfDay; }
+    bool isNight() const;
+
+    // Brightness for the frame in leds[]; call right before pushing it
+    uint8_t frameBrightness(const CRGB* leds, int count);
+
+    // Estimate for the last frame at the brightness it was given
+    uint32_t lastCurrent() const { return current; }
+
+private:
+    uint32_t budget = POWER_BUDGET_MA;  // 0 = unlimited
+    uint8_t day = BRIGHTNESS;
+    uint8_t night = NIGHT_BRIGHTNESS;
+    uint8_t nightStart = NIGHT_START_HOUR;
+    uint8_t nightEnd = NIGHT_END_HOUR;
+    int clock = -1;
+    uint32_t current = 0;
+};
+
+extern PowerManager powerManager;
+
+#endif // POWER_H
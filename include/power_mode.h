@@ -0,0 +1,90 @@
+#ifndef POWER_MODE_H
+#define POWER_MODE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "settings.h"
+
+enum PowerModeId : uint8_t {
+    POWER_FULL,      // Radio in default modem sleep, CPU at full clock
+    POWER_LOW,       // Max modem sleep between fetches, DFS, light sleep between frames
+    POWER_MODE_COUNT
+};
+
+#define LOW_POWER_MAX_IDLE 100    // ms; the loop still checks WiFi and serial this often
+
+// Typical ESP32-S3 board draw per state, in mA, for the current estimate.
+// Radio figures are averages over the beacon cycle.
+#define BOARD_CPU_BASE_MA 12      // Digital core with the clocks running
+#define BOARD_CPU_UA_PER_MHZ 140  // Plus this per MHz while code runs
+#define BOARD_IDLE_MA 20          // Cores waiting for an interrupt
+#define BOARD_LIGHT_SLEEP_MA 2    // Light sleep, RAM and LED data line held
+#define BOARD_RADIO_ON_MA 95      // Receiver on for a transfer
+#define BOARD_RADIO_IDLE_MA 25    // Default modem sleep, up for every beacon
+#define BOARD_RADIO_SLEEP_MA 5    // Max modem sleep, up every third beacon
+
+// Time and estimated charge spent in one mode
+struct PowerResidency {
+    uint32_t ms = 0;
+    uint32_t awakeMs = 0;         // Loop rendering or a transfer running
+    uint32_t radioMs = 0;         // Transfers
+    uint64_t boardMaMs = 0;
+    uint64_t ledMaMs = 0;
+};
+
+// Switches between full and low power and keeps per-mode averages of the
+// estimated current. In low power the chip runs under ESP-IDF power
+// management: the CPU clock drops to LOW_POWER_CPU_MIN_MHZ whenever no task
+// holds it up, and with tickless idle the chip light-sleeps until the next
+// timer. The loop blocks until its next frame is due, so those wakeups land
+// on the scroll cadence; the radio stays in max modem sleep except while the
+// network task fetches. Whatever the IDF build doesn't support (light sleep
+// needs tickless idle) is left out and shown in the report.
+class PowerMode {
+public:
+    // Call from setup() after WiFi is started
+    void begin(uint8_t mode);
+    // Switch at runtime; false if the mode is unknown
+    bool set(uint8_t mode);
+
+    uint8_t mode() const { return current; }
+    bool lowPower() const { return current == POWER_LOW; }
+
+    // Loop task: wait until deadline (millis), at most LOW_POWER_MAX_IDLE.
+    // In full power this is the old delay(1).
+    void idleUntil(unsigned long deadline);
+
+    // Network task: around a fetch and its publish, radio awake and CPU at full clock
+    void beginTransfer();
+    void endTransfer();
+
+    // LED output: the RMT timing needs a steady APB clock and no sleep
+    void beginOutput();
+    void endOutput();
+
+    // Average estimated board and LED current in a mode, mA
+    uint32_t averageCurrent(uint8_t mode) const;
+    uint32_t averageLedCurrent(uint8_t mode) const;
+
+    // One line for the log, and the per-mode table for the "power" command
+    void printSummary(Print& out);
+    void printReport(Print& out);
+
+private:
+    void account(unsigned long now);
+    void apply();
+
+    uint8_t current = POWER_FULL;
+    bool started = false;
+    bool scaling = false;             // DFS active
+    bool lightSleep = false;          // Automatic light sleep active
+    unsigned long accountedAt = 0;
+    uint32_t idleMs = 0;              // Loop idle since accountedAt
+    unsigned long transferStart = 0;
+    std::atomic<uint32_t> transferMs{0};  // From the network task
+    PowerResidency modes[POWER_MODE_COUNT];
+};
+
+extern PowerMode powerMode;
+
+#endif // POWER_MODE_H
@@ -0,0 +1,22 @@
+#ifndef READING_CACHE_H
+#define READING_CACHE_H
+
+#include <Arduino.h>
+#include "snapshot.h"
+
+#define CACHE_NAMESPACE "readings"
+#define CACHE_VERSION 4
+#define CACHE_WRITE_INTERVAL 900000  // At most one flash write per 15 minutes
+
+// Last good readings kept in NVS, so the ticker has something to show
+// straight after boot while WiFi and the first fetches are still pending.
+
+// Restore the cached readings. Returns false if there are none or they were
+// saved by a firmware with a different SensorSnapshot layout.
+bool loadCachedReadings(SensorSnapshot& out);
+
+// Save the readings if they changed and the last write is at least
+// CACHE_WRITE_INTERVAL ago. Cheap to call often; returns true when written.
+bool saveCachedReadings(const SensorSnapshot& readings);
+
+#endif // READING_CACHE_H
@@ -0,0 +1,80 @@
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+// Sensor configuration
+#define PM_SENSOR_ID "85707"    // Particulate matter sensor
+#define TEMP_SENSOR_ID "85708"  // Temperature sensor
+#define API_HOST "data.sensor.community"
+#define API_PATH "/airrohr/v1/sensor/"
+#define MAX_RETRIES 3
+#define RETRY_DELAY 1000  // 1 second between retries
+#define HTTP_TIMEOUT 10000 // 10 seconds timeout
+#define HTTP_COMPRESSION 1    // Ask for gzip replies and inflate them while parsing
+#define SENSOR_DOC_SIZE 1024   // One filtered sensor.community reading
+#define WEATHER_DOC_SIZE 512   // Filtered OpenMeteo reply
+#define STALE_AFTER 900000     // Readings not refreshed for 15 minutes are marked stale
+
+// PM2.5 is fused from these stations (up to 5), fetched in parallel: the
+// median of the ones that agree, so one faulty or offline sensor doesn't
+// skew the display. The first is the home station whose location is shown.
+#define PM_SENSOR_IDS {PM_SENSOR_ID}  // e.g. {PM_SENSOR_ID, "12345", "23456"}
+#define PM_STATION_MAX_AGE 1800       // Seconds; stations this far behind the newest reading are left out
+#define PM_OUTLIER_MIN 5.0f           // ug/m3 from the median that never counts as an outlier
+
+// Area mode: instead of PM_SENSOR_IDS, one request for every sensor within
+// PM_AREA_RADIUS of the home coordinates; the nearest ones are fused
+#define PM_AREA_MODE 0
+#define PM_AREA_LATITUDE 18.7883
+#define PM_AREA_LONGITUDE 98.9853
+#define PM_AREA_RADIUS 3.0            // km
+
+// Polling: starting estimates of how often each upstream publishes; the
+// scheduler refines them from the reading timestamps
+#define SENSOR_CADENCE 145000      // sensor.community sensors report about every 2.5 minutes
+#define WEATHER_CADENCE 900000     // OpenMeteo "current" block, every 15 minutes
+#define POLL_MIN_INTERVAL 30000
+#define POLL_MAX_INTERVAL 3600000
+
+// Telemetry batches to an MQTT broker; set MQTT_BROKER in config.h to enable
+#define MQTT_PORT 1883
+#define MQTT_TOPIC "airquality"    // Published to <topic>/<device id>/telemetry
+#define MQTT_INTERVAL 300000       // One batch every 5 minutes, 0 = one per fetch
+#define MQTT_FLUSH_DELAY 60000     // Longest a batch waits for a fetch to share the radio with
+#define MQTT_QUEUE_SIZE 12         // Batches kept while the broker is unreachable
+
+// Power: 0 full, 1 low (WiFi modem sleep between fetches, CPU clock
+// scaling, light sleep between frames), switchable with the "power" command
+#define POWER_MODE 0
+#define LOW_POWER_CPU_MAX_MHZ 160  // While rendering or fetching
+#define LOW_POWER_CPU_MIN_MHZ 80   // Otherwise; lower would also slow the APB clock
+
+// Serial logging, written out by a background task
+#define LOG_LEVEL 3                // 0 off, 1 errors, 2 warnings, 3 info, 4 debug
+#define LOG_QUEUE_LINES 16         // Lines waiting to be sent; more are dropped and counted
+
+// LED Matrix configuration
+#define LED_PIN     4
+#define PANEL_WIDTH 32
+#define PANEL_HEIGHT 8
+#define PANEL_COUNT 1           // 32x8 panels chained left to right: 2 = 64x8, 4 = 128x8
+#define PANEL_ORDER SERPENTINE_EVEN_FORWARD  // ColumnOrder, see matrix_layout.h
+#define PANEL_ROTATION ROTATE_0
+#define PANEL_PARALLEL 1        // Each panel on its own data pin, pushed in parallel
+#define LED_PIN_2   5           // Data pins of panels 2-4 when PANEL_PARALLEL
+#define LED_PIN_3   6
+#define LED_PIN_4   7
+#define MATRIX_WIDTH (PANEL_WIDTH * PANEL_COUNT)
+#define MATRIX_HEIGHT PANEL_HEIGHT
+#define NUM_LEDS (MATRIX_WIDTH * MATRIX_HEIGHT)
+#define BRIGHTNESS  40
+#define POWER_BUDGET_MA 1000    // Estimated LED current limit, brightness drops to stay below (0 = none)
+#define NIGHT_BRIGHTNESS 8      // Brightness at night, 0 blanks the panel
+#define NIGHT_START_HOUR 22     // Local time; equal start and end disables night mode
+#define NIGHT_END_HOUR 6
+#define SCROLL_FRAME_MS 20  // Target frame period, one column per frame
+#define MAX_FPS 50          // Cap on frames pushed to the LEDs per second
+#define LED_ASYNC_OUTPUT 1  // Send frames from a separate task while the next one renders
+#define STATIC_HOLD_MS 3000 // How long a message that fits the matrix stays up
+#define MAX_MESSAGE_LENGTH 300
+
+#endif // SETTINGS_H
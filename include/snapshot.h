@@ -0,0 +1,122 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+#ifdef ESP32
+#include <freertos/FreeRTOS.h>
+#endif
+
+#define SPARKLINE_COLUMNS 24  // One bar per hour of the last day
+
+// Latest readings, filled by the network task and shown by the renderer
+struct SensorSnapshot {
+    // Sensor.Community
+    char pm25[10];
+    char temperature[10];
+    char altitude[10];
+    char localTime[20];
+    uint8_t pmStations;           // Stations that went into pm25
+
+    // OpenMeteo
+    float currentTemp;            // Current temperature
+    float currentPressure;        // Current pressure in hPa
+    int currentWeatherCode;       // Current weather code
+    float tomorrowMinTemp;        // Tomorrow's min temperature
+    float tomorrowMaxTemp;        // Tomorrow's max temperature
+    int tomorrowWeatherCode;      // Tomorrow's weather code
+
+    bool restored;                // Loaded from the NVS cache, PM not refreshed yet
+
+    // Bumped by the network task whenever the matching values change,
+    // so the renderer only re-formats what is new
+    uint32_t pmVersion;           // pm25, localTime, altitude
+    uint32_t temperatureVersion;
+    uint32_t weatherVersion;
+
+    // millis() when each source last stored new values, 0 = not since boot
+    uint32_t pmFetchedAt;
+    uint32_t temperatureFetchedAt;
+    uint32_t weatherFetchedAt;
+
+    // From the on-device history (history.h), fixed point x10,
+    // HISTORY_NO_DATA until there is a reading
+    int16_t pmMeanHour = INT16_MIN;
+    int16_t pmMeanDay = INT16_MIN;
+    int8_t pmTrend = 0;                      // -1 falling, 0 steady, 1 rising
+    uint8_t pmSparkline[SPARKLINE_COLUMNS] = {};  // Hourly bar heights 0-8, oldest first
+    int16_t temperatureMinDay = INT16_MIN;
+    int16_t temperatureMaxDay = INT16_MIN;
+};
+
+// Single-writer sequence lock. The writer never waits; a reader copies the
+// value and retries only if a write overlapped the copy, so it never sees a
+// torn value and never blocks the writer.
+template <typename T>
+class SeqLock {
+public:
+    // Publish a new value (only ever called from one task)
+    void write(const T& value) {
+        uint32_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);   // odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&data, &value, sizeof(T));
+        seq.store(s + 2, std::memory_order_release);   // even: stable
+    }
+
+    // Copy the latest consistent value into out
+    void read(T& out) const {
+        uint32_t before, after;
+        do {
+            before = seq.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            memcpy(&out, &data, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = seq.load(std::memory_order_relaxed);
+            if (before == after) return;
+        } while (true);
+    }
+
+    // Changes every time a new value is published
+    uint32_t version() const { return seq.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<uint32_t> seq{0};
+    T data{};
+};
+
+// Lock for counters that several tasks update and others read. A portMUX
+// critical section on the device, which also keeps the other core out; an
+// atomic flag on the host. Held for a few stores or a copy, never for I/O.
+class SpinLock {
+public:
+#ifdef ESP32
+    void lock() { portENTER_CRITICAL(&mux); }
+    void unlock() { portEXIT_CRITICAL(&mux); }
+#else
+    void lock() { while (flag.test_and_set(std::memory_order_acquire)) {} }
+    void unlock() { flag.clear(std::memory_order_release); }
+#endif
+
+private:
+#ifdef ESP32
+    portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+#else
+    std::atomic_flag flag = ATOMIC_FLAG_INIT;
+#endif
+};
+
+// Holds a SpinLock until the end of the scope
+class SpinLockGuard {
+public:
+    explicit SpinLockGuard(SpinLock& lock) : held(lock) { held.lock(); }
+    ~SpinLockGuard() { held.unlock(); }
+    SpinLockGuard(const SpinLockGuard&) = delete;
+    SpinLockGuard& operator=(const SpinLockGuard&) = delete;
+
+private:
+    SpinLock& held;
+};
+
+#endif // SNAPSHOT_H
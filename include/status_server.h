@@ -0,0 +1,41 @@
+#ifndef STATUS_SERVER_H
+#define STATUS_SERVER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include "snapshot.h"
+
+#define STATUS_SERVER_PORT 80
+#define STATUS_REQUEST_TIMEOUT 500  // Give up on a client that sends no complete request
+#define STATUS_RESPONSE_SIZE 2048
+
+// Minimal HTTP server for other devices on the LAN: GET / or /status returns
+// the published readings, their ages and the telemetry counters as JSON.
+// One client at a time, Connection: close. Runs in its own task and only
+// reads the SeqLock, so a slow client never holds up the renderer.
+class StatusServer {
+public:
+    explicit StatusServer(uint16_t port = STATUS_SERVER_PORT) : server(port) {}
+
+    void begin(const SeqLock<SensorSnapshot>* source);
+
+    // Serve one waiting client, if any. Returns true if a request was answered.
+    bool poll();
+
+private:
+    bool readRequest(WiFiClient& client, char* path, size_t size);
+    void respond(WiFiClient& client, const char* status, const char* body, size_t length);
+
+    WiFiServer server;
+    const SeqLock<SensorSnapshot>* readings = nullptr;
+    SensorSnapshot snapshot;
+    char body[STATUS_RESPONSE_SIZE];
+};
+
+extern StatusServer statusServer;
+
+// The JSON document for one snapshot plus the live telemetry counters.
+// Returns its length, or 0 if it did not fit.
+size_t buildStatusJson(const SensorSnapshot& snapshot, char* out, size_t size);
+
+#endif // STATUS_SERVER_H
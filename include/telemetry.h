@@ -0,0 +1,153 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+
+#define TELEMETRY_SUMMARY_INTERVAL 60000  // Periodic summary line on Serial
+#define FETCH_ERROR_PARSE (-20)           // JSON error, next to the HTTPC_ERROR_* codes
+
+// Figures of a histogram, copied out so they can be printed without the lock
+struct HistogramSummary {
+    uint32_t count;
+    uint32_t min;
+    uint32_t average;
+    uint32_t p99;
+    uint32_t max;
+};
+
+// Log-scale histogram of durations in microseconds. Four buckets per power
+// of two up to ~33 s, so percentiles are within ~20% in under 400 bytes.
+class Histogram {
+public:
+    void record(uint32_t value);
+    void reset();
+
+    uint32_t count() const { return samples; }
+    uint32_t min() const { return samples ? minValue : 0; }
+    uint32_t max() const { return maxValue; }
+    uint32_t average() const { return samples ? (uint32_t)(sum / samples) : 0; }
+    uint32_t percentile(uint8_t p) const;
+    HistogramSummary summary() const;
+
+private:
+    static const int BUCKETS = 96;
+    static int bucketFor(uint32_t value);
+    static uint32_t bucketUpper(int bucket);
+
+    uint32_t buckets[BUCKETS] = {};
+    uint32_t samples = 0;
+    uint32_t minValue = UINT32_MAX;
+    uint32_t maxValue = 0;
+    uint64_t sum = 0;
+};
+
+enum FetchSource {
+    SOURCE_PM,
+    SOURCE_TEMP,
+    SOURCE_WEATHER,
+    SOURCE_COUNT
+};
+
+struct FetchStats {
+    uint32_t attempts = 0;
+    uint32_t failures = 0;
+    uint32_t retries = 0;
+    int lastError = 0;                 // HTTPC_ERROR_*, FETCH_ERROR_PARSE or HTTP status
+    uint16_t transportErrors[12] = {}; // Index -code for HTTPC_ERROR_* (-1..-11), 0 = other
+    uint16_t httpErrors = 0;           // Non-200 replies
+    uint16_t parseErrors = 0;
+    Histogram latencyMs;
+};
+
+struct WifiStats {
+    uint32_t attempts = 0;             // WiFi.begin() calls
+    uint32_t failures = 0;             // Attempts that timed out or were refused
+    uint32_t connects = 0;
+    uint32_t losses = 0;               // Established links that dropped
+    uint8_t lastReason = 0;            // Last disconnect reason (wifi_err_reason_t)
+    Histogram reconnectMs;             // Boot or link loss until an IP was assigned
+};
+
+struct SystemStats {
+    uint32_t freeHeap = 0;
+    uint32_t minFreeHeap = 0;
+    uint32_t largestFreeBlock = 0;
+    uint32_t lowestLargestBlock = 0;   // Smallest largestFreeBlock seen since boot
+    uint32_t loopStackFree = 0;        // Stack high-water marks, bytes never used
+    uint32_t networkStackFree = 0;
+
+    // Share of the free heap not usable as one block, in percent
+    uint8_t fragmentation() const {
+        return freeHeap ? 100 - (uint8_t)((uint64_t)largestFreeBlock * 100 / freeHeap) : 0;
+    }
+};
+
+// Runtime metrics: frame timing, fetch results and heap/stack health.
+// Frame numbers cover the current summary window; fetch numbers are totals.
+// The loop, the network task and WiFi events record from both cores, so
+// every access takes a short spinlock; readers get copies.
+class Telemetry {
+public:
+    void recordFrame(uint32_t renderUs);
+    void recordShow(uint32_t showUs);      // FastLED.show() alone, from whichever task runs it
+    void recordLateFrame();
+    void recordSkippedFrame();  // Unchanged, not pushed
+    void recordPower(uint32_t milliamps);  // Estimate per pushed frame
+    void recordFetch(FetchSource source, bool ok, uint32_t latencyMs, int retries, int error);
+    void setSystemStats(const SystemStats& stats);
+
+    void recordWifiAttempt();
+    void recordWifiFailure(uint8_t reason);
+    void recordWifiConnected(uint32_t offlineMs);
+    void recordWifiLost(uint8_t reason);
+
+    void setTargetFps(float fps) { targetFps = fps; }
+    float achievedFps() const;
+
+    // One compact line, then a new frame window starts
+    void printSummary(Print& out);
+    // Everything, for the "stats" serial command
+    void printReport(Print& out) const;
+    void reset();
+
+    FetchStats fetchStats(FetchSource source) const;
+    WifiStats wifiStats() const;
+    SystemStats systemStats() const;
+    uint32_t lateFrameCount() const;
+    uint32_t skippedFrameCount() const;
+    uint32_t maxLedCurrent() const;
+
+private:
+    void startWindow();
+    float framesPerSecond(uint32_t frames, unsigned long since) const;
+
+    Histogram renderUs;
+    Histogram showUs;
+    Histogram ledMa;
+    uint32_t lateFrames = 0;
+    uint32_t skippedFrames = 0;
+    unsigned long windowStart = 0;
+    float targetFps = 0;
+    FetchStats fetches[SOURCE_COUNT];
+    WifiStats wifi;
+    SystemStats system;
+};
+
+extern Telemetry telemetry;
+
+// Records one fetch (with all its retries) when it goes out of scope
+class FetchRecorder {
+public:
+    explicit FetchRecorder(FetchSource source) : source(source), start(millis()) {}
+    ~FetchRecorder() { telemetry.recordFetch(source, ok, millis() - start, retries, error); }
+
+    bool ok = false;
+    int retries = 0;
+    int error = 0;
+
+private:
+    FetchSource source;
+    unsigned long start;
+};
+
+#endif // TELEMETRY_H
@@ -0,0 +1,72 @@
+#ifndef TICKER_H
+#define TICKER_H
+
+#include <Arduino.h>
+#include "snapshot.h"
+#include "settings.h"
+#include "font.h"
+
+// Weather codes mapping
+const char* getWeatherDescription(int code);
+
+// Freshness of the readings, shown as a marker next to their time
+enum DataStatus {
+    DATA_LIVE,
+    DATA_STALE,      // Online, but nothing new for STALE_AFTER
+    DATA_OFFLINE     // WiFi is down, showing the last known values
+};
+
+// Parts of the ticker, in display order
+enum TickerSegment {
+    SEGMENT_LOCATION,
+    SEGMENT_TIME,
+    SEGMENT_PM,
+    SEGMENT_TREND,           // 1 h / 24 h means and a trend arrow
+    SEGMENT_SPARKLINE,       // 24 h bar graph, drawn rather than written
+    SEGMENT_TEMPERATURE,
+    SEGMENT_NOW,
+    SEGMENT_TOMORROW,
+    SEGMENT_COUNT
+};
+
+// Bytes per segment, terminator included. The longest, "Tomorrow" with an
+// unknown code and two-digit frosts, is 49 bytes since the degree sign
+// takes two; test_ticker checks the worst case still fits.
+#define SEGMENT_TEXT_LENGTH 64
+
+// Build the ticker text from the latest readings
+void composeTickerMessage(const SensorSnapshot& readings, char* combinedMsg, size_t size,
+                          DataStatus status = DATA_LIVE);
+
+// Ticker kept as rasterized segments. Each segment remembers the version
+// of the readings it was built from, so update() only re-formats and
+// re-rasterizes the segments whose values changed and then joins the
+// cached column strips. Allocates nothing.
+class TickerComposer {
+public:
+    // Bring the segments up to date. Returns true if the ticker changed.
+    bool update(const SensorSnapshot& readings, DataStatus status);
+
+    const uint8_t* columns() const { return strip; }
+    int width() const { return stripWidth; }
+    const char* text() const { return message; }
+
+    // Bumped every time the segment is rebuilt
+    uint32_t segmentVersion(TickerSegment segment) const { return segments[segment].version; }
+
+private:
+    struct Segment {
+        char text[SEGMENT_TEXT_LENGTH];
+        uint8_t columns[SEGMENT_TEXT_LENGTH * CHAR_COLUMNS];
+        int width = 0;
+        uint32_t source = 0;       // Input key the segment was built from
+        uint32_t version = 0;      // 0 = never built
+    };
+
+    Segment segments[SEGMENT_COUNT];
+    uint8_t strip[MAX_MESSAGE_LENGTH * CHAR_COLUMNS];
+    int stripWidth = 0;
+    char message[MAX_MESSAGE_LENGTH];
+};
+
+#endif // TICKER_H
@@ -0,0 +1,52 @@
+#ifndef WIFI_MANAGER_H
+#define WIFI_MANAGER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+#define WIFI_CONNECT_TIMEOUT 20000  // Abandon an attempt that has no IP by then
+#define WIFI_BACKOFF_MIN 1000       // Retry delay after the first failure, doubled per failure
+#define WIFI_BACKOFF_MAX 120000
+
+// What changed in the last update(), for status messages
+enum WifiEvent {
+    WIFI_EVENT_NONE,
+    WIFI_EVENT_CONNECTED,    // First connection since boot
+    WIFI_EVENT_RECONNECTED,
+    WIFI_EVENT_LOST
+};
+
+// Non-blocking station connect/reconnect. Link changes arrive through
+// WiFi.onEvent; failed attempts are retried with exponential backoff plus
+// jitter, so an AP that is down never freezes loop() and a room full of
+// displays doesn't hammer it in lockstep when it comes back.
+class WifiManager {
+public:
+    void begin(const char* ssid, const char* password);
+
+    // Advance the state machine; call from loop(). Never blocks.
+    WifiEvent update(unsigned long now);
+
+    bool connected() const { return state == STATE_CONNECTED; }
+
+private:
+    enum State { STATE_CONNECTING, STATE_CONNECTED, STATE_BACKOFF };
+
+    static void onEvent(arduino_event_id_t event, arduino_event_info_t info);
+    void startAttempt(unsigned long now);
+    void scheduleRetry(unsigned long now);
+
+    const char* ssid = nullptr;
+    const char* password = nullptr;
+    State state = STATE_BACKOFF;
+    bool everConnected = false;
+    unsigned long attemptStart = 0;
+    unsigned long retryAt = 0;
+    unsigned long offlineSince = 0;   // Boot or link loss, for the reconnect time
+    uint16_t failures = 0;            // Failed attempts in the current outage
+    uint16_t attempts = 0;
+};
+
+extern WifiManager wifiManager;
+
+#endif // WIFI_MANAGER_H
@@ -0,0 +1,189 @@
+#include "bench.h"
+#include <chrono>
+#include <pthread.h>
+#include <vector>
+#include "display.h"
+#include "fetch.h"
+#include "heap_tracker.h"
+#include "logger.h"
+#include "mqtt_publisher.h"
+#include "settings.h"
+#include "sim.h"
+#include "status_server.h"
+#include "ticker.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double elapsedNs(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+// Run fn on a thread whose stack is pre-filled with a pattern and return
+// how many bytes of it were touched
+const size_t STACK_SIZE = 64 * 1024;
+const uint8_t STACK_FILL = 0xA5;
+
+struct StackRun {
+    void (*fn)();
+};
+
+void* stackThread(void* arg) {
+    static_cast<StackRun*>(arg)->fn();
+    return nullptr;
+}
+
+size_t measureStack(void (*fn)()) {
+    std::vector<uint8_t> stack(STACK_SIZE, STACK_FILL);
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, stack.data(), stack.size());
+    StackRun run = {fn};
+    pthread_t thread;
+    if (pthread_create(&thread, &attr, stackThread, &run) != 0) return 0;
+    pthread_join(thread, nullptr);
+    pthread_attr_destroy(&attr);
+
+    size_t untouched = 0;
+    while (untouched < stack.size() && stack[untouched] == STACK_FILL) untouched++;
+    return stack.size() - untouched;  // Stack grows down from the end
+}
+
+void report(const char* name, double value, const char* unit, const char* extra = "") {
+    printf("  %-34s %10.1f %-9s %s\n", name, value, unit, extra);
+}
+
+void fetchPM() { fetchSensorData(PM_SENSOR_ID, true); }
+void fetchStations() { fetchPMData(); }
+void fetchArea() { fetchAreaData(); }
+void fetchTemp() { fetchSensorData(TEMP_SENSOR_ID, false); }
+void fetchWeather() { fetchWeatherData(); }
+
+void benchParse(const char* name, void (*fn)(), int iterations) {
+    fn();  // Warm up: static filters, first-fetch banner, connection
+
+    size_t base = heap::current();
+    heap::resetPeak();
+    sim::NetStats before = sim::netStats();
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < iterations; i++) fn();
+    double us = elapsedNs(start) / 1000.0 / iterations;
+    sim::NetStats after = sim::netStats();
+    size_t heapPeak = heap::peak() - base;
+    size_t stackPeak = measureStack(fn);
+
+    char extra[128];
+    snprintf(extra, sizeof(extra), "heap peak %zu B, stack %zu B, %lu connects/%lu requests, %lu B received",
+             heapPeak, stackPeak, after.connects - before.connects, after.requests - before.requests,
+             (after.bytesSent - before.bytesSent) / iterations);
+    report(name, us, "us/parse", extra);
+}
+
+}  // namespace
+
+int runBenchmarks(int iterations) {
+    Serial.mute(true);
+    addLedControllers();
+
+    printf("Parse (%d iterations)\n", iterations);
+    benchParse("fetchSensorData PM2.5", fetchPM, iterations);
+    benchParse("fetchSensorData temperature", fetchTemp, iterations);
+    benchParse("fetchPMData (all stations)", fetchStations, iterations);
+    benchParse("fetchAreaData (100 KB feed)", fetchArea, iterations / 10 + 1);
+    benchParse("fetchWeatherData", fetchWeather, iterations);
+    sim::setChunkSize(64);
+    benchParse("fetchWeatherData (chunked)", fetchWeather, iterations);
+    sim::setChunkSize(0);
+    sim::setGzip(true);
+    benchParse("fetchSensorData PM2.5 (gzip)", fetchPM, iterations);
+    benchParse("fetchAreaData (gzip)", fetchArea, iterations / 10 + 1);
+    benchParse("fetchWeatherData (gzip)", fetchWeather, iterations);
+    sim::setChunkSize(64);
+    benchParse("fetchWeatherData (gzip, chunked)", fetchWeather, iterations);
+    sim::setChunkSize(0);
+    sim::setGzip(false);
+
+    SensorSnapshot readings = netReadings;
+    char message[MAX_MESSAGE_LENGTH];
+    composeTickerMessage(readings, message, sizeof(message));
+
+    printf("Render (%zu char message)\n", strlen(message));
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < iterations; i++) scroller.start(message, CRGB(255, 20, 147));
+    report("Scroller::start (rasterize)", elapsedNs(start) / 1000.0 / iterations, "us");
+
+    static const char thai[] = "\xE0\xB8\x9D\xE0\xB8\xB8\xE0\xB9\x88\xE0\xB8\x99 PM2.5 "
+                               "\xE0\xB8\xA7\xE0\xB8\xB1\xE0\xB8\x99\xE0\xB8\x99\xE0\xB8\xB5\xE0\xB9\x89";  // Dust today
+    static uint8_t thaiColumns[sizeof(thai) * CHAR_COLUMNS];
+    start = Clock::now();
+    for (int i = 0; i < iterations; i++) rasterizeText(thai, thaiColumns, sizeof(thaiColumns));
+    report("rasterizeText (Thai)", elapsedNs(start) / iterations, "ns");
+
+    unsigned long frames = 0;
+    unsigned long now = 0;
+    start = Clock::now();
+    for (int i = 0; i < iterations / 10 + 1; i++) {
+        scroller.start(message, CRGB(255, 20, 147));
+        while (!scroller.isIdle()) {
+            now += SCROLL_FRAME_MS;
+            if (scroller.tick(now)) frames++;
+        }
+    }
+    report("Scroller::tick (render + show)", elapsedNs(start) / frames, "ns/frame");
+
+    printf("Compose\n");
+    start = Clock::now();
+    for (int i = 0; i < iterations; i++) composeTickerMessage(readings, message, sizeof(message));
+    report("composeTickerMessage (full text)", elapsedNs(start) / 1000.0 / iterations, "us");
+
+    TickerComposer ticker;
+    ticker.update(readings, DATA_LIVE);
+    size_t heapBase = heap::current();
+    heap::resetPeak();
+    start = Clock::now();
+    for (int i = 0; i < iterations; i++) ticker.update(readings, DATA_LIVE);
+    char extra[48];
+    snprintf(extra, sizeof(extra), "heap peak %zu B", heap::peak() - heapBase);
+    report("TickerComposer::update (unchanged)", elapsedNs(start) / iterations, "ns", extra);
+
+    start = Clock::now();
+    for (int i = 0; i < iterations; i++) {
+        readings.pmVersion++;  // One new PM reading: three segments rebuilt
+        ticker.update(readings, DATA_LIVE);
+    }
+    report("TickerComposer::update (new PM2.5)", elapsedNs(start) / 1000.0 / iterations, "us");
+
+    printf("Status server\n");
+    static char json[STATUS_RESPONSE_SIZE];
+    size_t length = 0;
+    heapBase = heap::current();
+    heap::resetPeak();
+    start = Clock::now();
+    for (int i = 0; i < iterations; i++) length = buildStatusJson(readings, json, sizeof(json));
+    snprintf(extra, sizeof(extra), "%zu B, heap peak %zu B", length, heap::peak() - heapBase);
+    report("buildStatusJson", elapsedNs(start) / 1000.0 / iterations, "us", extra);
+
+    printf("MQTT telemetry\n");
+    static char payload[MQTT_PAYLOAD_SIZE];
+    heapBase = heap::current();
+    heap::resetPeak();
+    start = Clock::now();
+    for (int i = 0; i < iterations; i++) length = buildTelemetryPayload(readings, 0, payload, sizeof(payload));
+    snprintf(extra, sizeof(extra), "%zu of %d B, heap peak %zu B", length, MQTT_PAYLOAD_SIZE, heap::peak() - heapBase);
+    report("buildTelemetryPayload", elapsedNs(start) / 1000.0 / iterations, "us", extra);
+
+    printf("Logging\n");
+    heapBase = heap::current();
+    heap::resetPeak();
+    start = Clock::now();
+    for (int i = 0; i < iterations; i++) LOG_INFO("%s | PM2.5: %s µg/m³", readings.localTime, readings.pm25);
+    snprintf(extra, sizeof(extra), "heap peak %zu B", heap::peak() - heapBase);
+    report("LOG_INFO (formatted and sent)", elapsedNs(start) / iterations, "ns", extra);
+    start = Clock::now();
+    for (int i = 0; i < iterations; i++) LOG_DEBUG("%s | PM2.5: %s µg/m³", readings.localTime, readings.pm25);
+    report("LOG_DEBUG (compiled out)", elapsedNs(start) / iterations, "ns");
+
+    Serial.mute(false);
+    return 0;
+}
@@ -0,0 +1,7 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// Render and parse benchmarks over the recorded fixtures
+int runBenchmarks(int iterations);
+
+#endif // BENCH_H
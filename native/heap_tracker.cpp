@@ -0,0 +1,83 @@
+#include "heap_tracker.h"
+#include <malloc.h>
+#include <new>
+#include <stdlib.h>
+
+extern "C" {
+void* __real_malloc(size_t size);
+void __real_free(void* ptr);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+}
+
+namespace {
+
+long liveBytes = 0;
+long peakBytes = 0;
+unsigned long allocationCount = 0;
+
+void track(long delta) {
+    liveBytes += delta;
+    if (liveBytes > peakBytes) peakBytes = liveBytes;
+}
+
+}  // namespace
+
+extern "C" {
+
+void* __wrap_malloc(size_t size) {
+    void* ptr = __real_malloc(size);
+    if (ptr) {
+        allocationCount++;
+        track(malloc_usable_size(ptr));
+    }
+    return ptr;
+}
+
+void __wrap_free(void* ptr) {
+    if (ptr) track(-(long)malloc_usable_size(ptr));
+    __real_free(ptr);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    void* ptr = __real_calloc(count, size);
+    if (ptr) {
+        allocationCount++;
+        track(malloc_usable_size(ptr));
+    }
+    return ptr;
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    long before = ptr ? (long)malloc_usable_size(ptr) : 0;
+    void* result = __real_realloc(ptr, size);
+    if (result) {
+        allocationCount++;
+        track((long)malloc_usable_size(result) - before);
+    } else if (size == 0) {
+        track(-before);
+    }
+    return result;
+}
+
+}  // extern "C"
+
+void* operator new(size_t size) {
+    void* ptr = __wrap_malloc(size ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* ptr) noexcept { __wrap_free(ptr); }
+void operator delete[](void* ptr) noexcept { __wrap_free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { __wrap_free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { __wrap_free(ptr); }
+
+namespace heap {
+
+size_t current() { return liveBytes > 0 ? liveBytes : 0; }
+size_t peak() { return peakBytes > 0 ? peakBytes : 0; }
+void resetPeak() { peakBytes = liveBytes; }
+unsigned long allocations() { return allocationCount; }
+
+}  // namespace heap
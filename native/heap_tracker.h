@@ -0,0 +1,18 @@
+#ifndef HEAP_TRACKER_H
+#define HEAP_TRACKER_H
+
+#include <stddef.h>
+
+// Live and peak heap bytes allocated by the firmware code. malloc() and
+// friends are wrapped at link time (-Wl,--wrap=...), operator new is
+// overridden, so ArduinoJson's allocator and String are both covered.
+namespace heap {
+
+size_t current();
+size_t peak();
+void resetPeak();       // Start a new peak window at the current level
+unsigned long allocations();
+
+}  // namespace heap
+
+#endif // HEAP_TRACKER_H
@@ -0,0 +1,39 @@
+// Host shim of the Arduino core, just enough for the hardware-independent
+// parts of the firmware. Time comes from sim.h: delay() advances a virtual
+// clock instead of sleeping, so simulations run at full speed.
+#ifndef ARDUINO_SHIM_H
+#define ARDUINO_SHIM_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <math.h>
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "HardwareSerial.h"
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define memcpy_P memcpy
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+inline uint32_t getCpuFrequencyMhz() { return 240; }
+
+inline bool isHexadecimalDigit(int c) { return isxdigit(c) != 0; }
+
+#endif // ARDUINO_SHIM_H
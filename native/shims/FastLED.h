@@ -0,0 +1,81 @@
+#ifndef FASTLED_SHIM_H
+#define FASTLED_SHIM_H
+
+#include <Arduino.h>
+
+struct CRGB {
+    enum HTMLColorCode : uint32_t {
+        Black = 0x000000,
+        Blue = 0x0000FF,
+        Green = 0x008000,
+        Red = 0xFF0000,
+        White = 0xFFFFFF,
+        Yellow = 0xFFFF00,
+        Orange = 0xFFA500,
+        Purple = 0x800080,
+        Cyan = 0x00FFFF
+    };
+
+    union {
+        struct {
+            uint8_t r;
+            uint8_t g;
+            uint8_t b;
+        };
+        uint8_t raw[3];
+    };
+
+    CRGB() : r(0), g(0), b(0) {}
+    CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+    CRGB(HTMLColorCode code) : r(code >> 16), g((code >> 8) & 0xFF), b(code & 0xFF) {}
+    CRGB(uint32_t code) : r(code >> 16), g((code >> 8) & 0xFF), b(code & 0xFF) {}
+
+    bool operator==(const CRGB& other) const { return r == other.r && g == other.g && b == other.b; }
+    bool operator!=(const CRGB& other) const { return !(*this == other); }
+};
+
+enum ESPIChipsets { WS2812B };
+enum EOrder { RGB, GRB };
+
+// Controller stand-in. show() hands the framebuffer to an optional hook
+// (see sim.h) instead of clocking it out.
+class CFastLED {
+public:
+    typedef void (*ShowHook)(const CRGB* leds, int count, uint8_t brightness);
+
+    template <ESPIChipsets CHIPSET, uint8_t DATA_PIN, EOrder ORDER>
+    void addLeds(CRGB* data, int count) {
+        // Panels on separate pins are adjacent slices of one array
+        if (leds == nullptr || data < leds) leds = data;
+        ledCount += count;
+    }
+
+    void setBrightness(uint8_t value) { brightness = value; }
+    uint8_t getBrightness() const { return brightness; }
+    void clear(bool writeData = false) {
+        for (int i = 0; i < ledCount; i++) leds[i] = CRGB();
+        if (writeData) show();
+    }
+    void show() {
+        showCount++;
+        if (hook && leds) hook(leds, ledCount, brightness);
+    }
+
+    void setShowHook(ShowHook h) { hook = h; }
+    unsigned long shows() const { return showCount; }
+
+private:
+    CRGB* leds = nullptr;
+    int ledCount = 0;
+    uint8_t brightness = 255;
+    unsigned long showCount = 0;
+    ShowHook hook = nullptr;
+};
+
+extern CFastLED FastLED;
+
+inline void fill_solid(CRGB* leds, int count, const CRGB& color) {
+    for (int i = 0; i < count; i++) leds[i] = color;
+}
+
+#endif // FASTLED_SHIM_H
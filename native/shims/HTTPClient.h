@@ -0,0 +1,42 @@
+#ifndef HTTP_CLIENT_SHIM_H
+#define HTTP_CLIENT_SHIM_H
+
+#include <WiFi.h>
+
+// Error codes as in the ESP32 HTTPClient
+#define HTTPC_ERROR_CONNECTION_REFUSED  (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED  (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED       (-4)
+#define HTTPC_ERROR_CONNECTION_LOST     (-5)
+#define HTTPC_ERROR_NO_STREAM           (-6)
+#define HTTPC_ERROR_NO_HTTP_SERVER      (-7)
+#define HTTPC_ERROR_TOO_LESS_RAM        (-8)
+#define HTTPC_ERROR_ENCODING            (-9)
+#define HTTPC_ERROR_STREAM_WRITE        (-10)
+#define HTTPC_ERROR_READ_TIMEOUT        (-11)
+
+#define HTTP_CODE_OK 200
+
+// Minimal HTTPClient over the simulated WiFiClient (GET only)
+class HTTPClient {
+public:
+    bool begin(const String& url);
+    void end() { client.stop(); }
+    int GET();
+    String getString();
+    WiFiClient& getStream() { return client; }
+    WiFiClient* getStreamPtr() { return &client; }
+    int getSize() { return size; }
+    void setTimeout(uint16_t timeout) { client.setTimeout(timeout); }
+    void setReuse(bool) {}
+    void useHTTP10(bool) {}
+
+private:
+    WiFiClient client;
+    std::string host;
+    std::string path;
+    int size = -1;
+};
+
+#endif // HTTP_CLIENT_SHIM_H
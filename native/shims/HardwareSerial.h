@@ -0,0 +1,38 @@
+#ifndef HARDWARE_SERIAL_SHIM_H
+#define HARDWARE_SERIAL_SHIM_H
+
+#include "Stream.h"
+
+// Serial port backed by stdout/stdin. mute() silences firmware output,
+// e.g. while benchmarking.
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long) {}
+    void end() {}
+    operator bool() const { return true; }
+
+    size_t write(uint8_t c) override {
+        if (!muted) fputc(c, stdout);
+        return 1;
+    }
+    size_t write(const uint8_t* buffer, size_t size) override {
+        if (!muted) fwrite(buffer, 1, size, stdout);
+        return size;
+    }
+    using Print::write;
+
+    int available() override;
+    int read() override;
+    int peek() override { return -1; }
+    int availableForWrite() { return 256; }
+    void flush() override { fflush(stdout); }
+
+    void mute(bool on) { muted = on; }
+
+private:
+    bool muted = false;
+};
+
+extern HardwareSerial Serial;
+
+#endif // HARDWARE_SERIAL_SHIM_H
@@ -0,0 +1,50 @@
+#ifndef PREFERENCES_SHIM_H
+#define PREFERENCES_SHIM_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <Arduino.h>
+
+// In-memory stand-in for the ESP32 NVS Preferences (bytes API only).
+// Contents last for the process, which is enough to simulate a reboot.
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false) {
+        space = name;
+        writable = !readOnly;
+        return true;
+    }
+    void end() { space.clear(); }
+
+    size_t getBytes(const char* key, void* buffer, size_t length) {
+        auto it = store().find(space + "/" + key);
+        if (it == store().end() || it->second.size() > length) return 0;
+        memcpy(buffer, it->second.data(), it->second.size());
+        return it->second.size();
+    }
+    size_t putBytes(const char* key, const void* value, size_t length) {
+        if (!writable) return 0;
+        const uint8_t* bytes = (const uint8_t*)value;
+        store()[space + "/" + key].assign(bytes, bytes + length);
+        writes()++;
+        return length;
+    }
+
+    // Number of putBytes() calls so far, to check flash wear in simulations
+    static unsigned long& writes() {
+        static unsigned long count = 0;
+        return count;
+    }
+
+private:
+    static std::map<std::string, std::vector<uint8_t>>& store() {
+        static std::map<std::string, std::vector<uint8_t>> data;
+        return data;
+    }
+
+    std::string space;
+    bool writable = false;
+};
+
+#endif // PREFERENCES_SHIM_H
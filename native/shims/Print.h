@@ -0,0 +1,58 @@
+#ifndef PRINT_SHIM_H
+#define PRINT_SHIM_H
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (size--) n += write(*buffer++);
+        return n;
+    }
+    size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+    virtual void flush() {}
+
+    size_t print(const char* s) { return write(s); }
+    size_t print(const String& s) { return write(s.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int n, int base = DEC) { return printNumber(base == HEX ? "%x" : "%d", n); }
+    size_t print(unsigned int n, int base = DEC) { return printNumber(base == HEX ? "%x" : "%u", n); }
+    size_t print(long n, int base = DEC) { return printNumber(base == HEX ? "%lx" : "%ld", n); }
+    size_t print(unsigned long n, int base = DEC) { return printNumber(base == HEX ? "%lx" : "%lu", n); }
+    size_t print(double n, int digits = 2) { return printf("%.*f", digits, n); }
+
+    size_t println() { return write("\r\n"); }
+    template <typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+    template <typename T> size_t println(T value, int format) { size_t n = print(value, format); return n + println(); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        char buffer[256];
+        va_list args;
+        va_start(args, format);
+        int length = vsnprintf(buffer, sizeof(buffer), format, args);
+        va_end(args);
+        if (length < 0) return 0;
+        if (length >= (int)sizeof(buffer)) length = sizeof(buffer) - 1;
+        return write((const uint8_t*)buffer, length);
+    }
+
+private:
+    template <typename T> size_t printNumber(const char* format, T n) {
+        char buffer[24];
+        int length = snprintf(buffer, sizeof(buffer), format, n);
+        return write((const uint8_t*)buffer, length);
+    }
+};
+
+#endif // PRINT_SHIM_H
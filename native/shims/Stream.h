@@ -0,0 +1,96 @@
+#ifndef STREAM_SHIM_H
+#define STREAM_SHIM_H
+
+#include "Print.h"
+
+unsigned long millis();
+void delay(unsigned long ms);
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeout) { streamTimeout = timeout; }
+    unsigned long getTimeout() const { return streamTimeout; }
+
+    virtual size_t readBytes(char* buffer, size_t length) {
+        size_t count = 0;
+        while (count < length) {
+            int c = timedRead();
+            if (c < 0) break;
+            buffer[count++] = (char)c;
+        }
+        return count;
+    }
+    size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+
+    size_t readBytesUntil(char terminator, char* buffer, size_t length) {
+        size_t count = 0;
+        while (count < length) {
+            int c = timedRead();
+            if (c < 0 || c == terminator) break;
+            buffer[count++] = (char)c;
+        }
+        return count;
+    }
+
+    String readStringUntil(char terminator) {
+        String result;
+        int c = timedRead();
+        while (c >= 0 && c != terminator) {
+            result += (char)c;
+            c = timedRead();
+        }
+        return result;
+    }
+
+    // Consume input until target has been read; false on timeout
+    bool find(const char* target) {
+        size_t length = strlen(target);
+        size_t matched = 0;
+        if (length == 0) return true;
+        for (;;) {
+            int c = timedRead();
+            if (c < 0) return false;
+            if (c == target[matched]) {
+                if (++matched == length) return true;
+            } else {
+                matched = (c == target[0]) ? 1 : 0;
+            }
+        }
+    }
+    bool find(char target) { char s[2] = {target, 0}; return find(s); }
+
+    // Like find(), but false as soon as terminator has been read
+    bool findUntil(const char* target, const char* terminator) {
+        size_t length = strlen(target);
+        size_t terminatorLength = strlen(terminator);
+        size_t matched = 0;
+        size_t terminated = 0;
+        for (;;) {
+            int c = timedRead();
+            if (c < 0) return false;
+            matched = c == target[matched] ? matched + 1 : (c == target[0] ? 1 : 0);
+            if (matched == length) return true;
+            terminated = c == terminator[terminated] ? terminated + 1 : (c == terminator[0] ? 1 : 0);
+            if (terminated == terminatorLength) return false;
+        }
+    }
+
+protected:
+    int timedRead() {
+        unsigned long start = millis();
+        do {
+            int c = read();
+            if (c >= 0) return c;
+            delay(1);
+        } while (millis() - start < streamTimeout);
+        return -1;
+    }
+
+    unsigned long streamTimeout = 1000;
+};
+
+#endif // STREAM_SHIM_H
@@ -0,0 +1,47 @@
+#ifndef WSTRING_SHIM_H
+#define WSTRING_SHIM_H
+
+#include <string>
+
+// Arduino String on top of std::string
+class String {
+public:
+    String() {}
+    String(const char* s) : value(s ? s : "") {}
+    String(const std::string& s) : value(s) {}
+    String(char c) : value(1, c) {}
+    String(int n) : value(std::to_string(n)) {}
+    String(unsigned int n) : value(std::to_string(n)) {}
+    String(long n) : value(std::to_string(n)) {}
+    String(unsigned long n) : value(std::to_string(n)) {}
+
+    const char* c_str() const { return value.c_str(); }
+    unsigned int length() const { return value.length(); }
+    char operator[](unsigned int i) const { return i < value.length() ? value[i] : 0; }
+
+    String& operator+=(const String& other) { value += other.value; return *this; }
+    String& operator+=(const char* other) { value += other; return *this; }
+    String& operator+=(char c) { value += c; return *this; }
+    friend String operator+(const String& a, const String& b) { return String(a.value + b.value); }
+    friend String operator+(const String& a, const char* b) { return String(a.value + b); }
+    friend String operator+(const char* a, const String& b) { return String(a + b.value); }
+    bool operator==(const String& other) const { return value == other.value; }
+    bool operator==(const char* other) const { return value == other; }
+
+    bool startsWith(const char* prefix) const { return value.rfind(prefix, 0) == 0; }
+    int indexOf(char c) const { size_t i = value.find(c); return i == std::string::npos ? -1 : (int)i; }
+    void trim() {
+        size_t first = value.find_first_not_of(" \t\r\n");
+        size_t last = value.find_last_not_of(" \t\r\n");
+        value = first == std::string::npos ? std::string() : value.substr(first, last - first + 1);
+    }
+
+    // Used by ArduinoJson's Arduino String support
+    bool concat(char c) { value += c; return true; }
+    bool concat(const char* s) { value += s; return true; }
+
+private:
+    std::string value;
+};
+
+#endif // WSTRING_SHIM_H
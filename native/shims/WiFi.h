@@ -0,0 +1,130 @@
+#ifndef WIFI_SHIM_H
+#define WIFI_SHIM_H
+
+#include <Arduino.h>
+#include <string>
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+#define WIFI_STA 1
+
+// Event API of the ESP32 core, reduced to the station events
+typedef enum {
+    ARDUINO_EVENT_WIFI_STA_CONNECTED,
+    ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+    ARDUINO_EVENT_WIFI_STA_GOT_IP,
+    ARDUINO_EVENT_MAX
+} arduino_event_id_t;
+
+typedef union {
+    struct {
+        uint8_t reason;
+    } wifi_sta_disconnected;
+} arduino_event_info_t;
+
+// Disconnect reasons (wifi_err_reason_t) the firmware looks at
+#define WIFI_REASON_ASSOC_LEAVE 8       // The station itself left, e.g. WiFi.disconnect()
+#define WIFI_REASON_BEACON_TIMEOUT 200  // AP out of range or gone
+
+typedef void (*WiFiEventFuncCb)(arduino_event_id_t event, arduino_event_info_t info);
+
+class IPAddress {
+public:
+    IPAddress() : address(0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : address(a | (b << 8) | (c << 16) | ((uint32_t)d << 24)) {}
+    IPAddress(uint32_t value) : address(value) {}
+    operator uint32_t() const { return address; }
+    uint8_t operator[](int index) const { return (address >> (8 * index)) & 0xFF; }
+    String toString() const {
+        char buffer[16];
+        snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", address & 0xFF, (address >> 8) & 0xFF,
+                 (address >> 16) & 0xFF, address >> 24);
+        return String(buffer);
+    }
+
+private:
+    uint32_t address;
+};
+
+// TCP client served by the simulated HTTP server in sim.cpp: each request
+// written to it is answered from the registered JSON fixtures. Clients
+// accepted by WiFiServer, and connections to any port other than 80 (e.g.
+// a local MQTT broker), are real sockets instead.
+class WiFiClient : public Stream {
+public:
+    int connect(const char* host, uint16_t port);
+    int connect(IPAddress ip, uint16_t port);
+    void stop();
+    uint8_t connected();
+    operator bool() { return connected(); }
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+
+    int available() override;
+    int read() override;
+    int read(uint8_t* buffer, size_t size);
+    int peek() override;
+    void setNoDelay(bool) {}
+
+private:
+    friend class WiFiServer;
+    void handleRequest();
+
+    int socket = -1;                        // Accepted connection, -1 for fixture clients
+    bool open = false;
+    char request[1024];
+    size_t requestLength = 0;
+    const std::string* response = nullptr;  // Prebuilt by the simulated server
+    size_t position = 0;
+};
+
+// Listens on a real localhost socket, so the firmware's server can be
+// exercised with curl
+class WiFiServer {
+public:
+    explicit WiFiServer(uint16_t port) : port(port) {}
+    void begin();
+    void setNoDelay(bool) {}
+    WiFiClient available();  // Never blocks; an invalid client if none is waiting
+
+private:
+    uint16_t port;
+    int listener = -1;
+};
+
+class WiFiClass {
+public:
+    void begin(const char*, const char*);
+    bool disconnect(bool = false, bool = false);
+    bool setAutoReconnect(bool) { return true; }
+    void onEvent(WiFiEventFuncCb callback) { eventHandler = callback; }
+    void fireEvent(arduino_event_id_t event, uint8_t reason = 0);
+    bool mode(int) { return true; }
+    bool setSleep(bool) { return true; }
+    wl_status_t status();
+    IPAddress localIP() { return IPAddress(192, 168, 1, 50); }
+    int hostByName(const char* host, IPAddress& result);
+    int8_t RSSI() { return -60; }
+    uint8_t* macAddress(uint8_t* mac) {
+        static const uint8_t address[6] = {0x24, 0x0a, 0xc4, 0x5e, 0x1d, 0x70};
+        memcpy(mac, address, sizeof(address));
+        return mac;
+    }
+
+private:
+    WiFiEventFuncCb eventHandler = nullptr;
+};
+
+extern WiFiClass WiFi;
+
+#endif // WIFI_SHIM_H
@@ -0,0 +1,84 @@
+#ifndef MINIZ_SHIM_H
+#define MINIZ_SHIM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zlib.h>
+
+// The tinfl subset of the ESP32 ROM miniz, on top of the host zlib.
+// zlib keeps its own window, so the caller's wrapping output buffer only
+// has to hold what each call produces. Its memory comes from a static
+// pool and is reused across streams, so inflating does not show up as
+// heap use in the benchmarks, as on the board where tinfl needs no heap.
+
+typedef uint8_t mz_uint8;
+typedef uint32_t mz_uint32;
+
+#define TINFL_LZ_DICT_SIZE 32768
+
+enum {
+    TINFL_FLAG_PARSE_ZLIB_HEADER = 1,
+    TINFL_FLAG_HAS_MORE_INPUT = 2,
+    TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF = 4,
+    TINFL_FLAG_COMPUTE_ADLER32 = 8
+};
+
+typedef enum {
+    TINFL_STATUS_BAD_PARAM = -3,
+    TINFL_STATUS_ADLER32_MISMATCH = -2,
+    TINFL_STATUS_FAILED = -1,
+    TINFL_STATUS_DONE = 0,
+    TINFL_STATUS_NEEDS_MORE_INPUT = 1,
+    TINFL_STATUS_HAS_MORE_OUTPUT = 2
+} tinfl_status;
+
+struct tinfl_decompressor {
+    z_stream stream;
+    int m_state;          // 0 until the first call after tinfl_init()
+    int windowBits;       // Of the open zlib stream, 0 if none yet
+};
+
+#define tinfl_init(r) do { (r)->m_state = 0; } while (0)
+
+inline voidpf tinflShimAlloc(voidpf, uInt items, uInt size) {
+    static uint8_t pool[64 * 1024] __attribute__((aligned(16)));
+    static size_t used = 0;
+    size_t bytes = ((size_t)items * size + 15) & ~(size_t)15;
+    if (used + bytes > sizeof(pool)) return Z_NULL;
+    used += bytes;
+    return pool + used - bytes;
+}
+inline void tinflShimFree(voidpf, voidpf) {}
+
+inline tinfl_status tinfl_decompress(tinfl_decompressor* r, const mz_uint8* pIn_buf_next, size_t* pIn_buf_size,
+                                     mz_uint8*, mz_uint8* pOut_buf_next, size_t* pOut_buf_size,
+                                     const mz_uint32 decomp_flags) {
+    z_stream& z = r->stream;
+    if (r->m_state == 0) {
+        int bits = (decomp_flags & TINFL_FLAG_PARSE_ZLIB_HEADER) ? 15 : -15;
+        if (r->windowBits == 0) {
+            z.zalloc = tinflShimAlloc;
+            z.zfree = tinflShimFree;
+            z.opaque = Z_NULL;
+            if (inflateInit2(&z, bits) != Z_OK) return TINFL_STATUS_FAILED;
+        } else if (inflateReset2(&z, bits) != Z_OK) {
+            return TINFL_STATUS_FAILED;
+        }
+        r->windowBits = bits;
+        r->m_state = 1;
+    }
+    z.next_in = (Bytef*)pIn_buf_next;
+    z.avail_in = (uInt)*pIn_buf_size;
+    z.next_out = pOut_buf_next;
+    z.avail_out = (uInt)*pOut_buf_size;
+    int rc = inflate(&z, Z_NO_FLUSH);
+    *pIn_buf_size -= z.avail_in;
+    *pOut_buf_size -= z.avail_out;
+
+    if (rc == Z_STREAM_END) return TINFL_STATUS_DONE;
+    if (rc != Z_OK && rc != Z_BUF_ERROR) return TINFL_STATUS_FAILED;
+    if (z.avail_out == 0) return TINFL_STATUS_HAS_MORE_OUTPUT;
+    return (decomp_flags & TINFL_FLAG_HAS_MORE_INPUT) ? TINFL_STATUS_NEEDS_MORE_INPUT : TINFL_STATUS_FAILED;
+}
+
+#endif // MINIZ_SHIM_H
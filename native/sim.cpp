@@ -0,0 +1,423 @@
+#include "sim.h"
+#include <HTTPClient.h>
+#include <WiFi.h>
+#include <chrono>
+#include <errno.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string.h>
+#include <string>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+#include <zlib.h>
+#include "display.h"
+
+HardwareSerial Serial;
+WiFiClass WiFi;
+CFastLED FastLED;
+
+namespace {
+
+// Responses are built up front, so serving a request allocates nothing
+// and the heap numbers only reflect the firmware
+struct Fixture {
+    std::string prefix;
+    std::string body;
+    std::string response;
+};
+
+std::vector<Fixture> fixtures;
+size_t chunkSize = 0;
+const char* bodyEncoding = nullptr;  // Content-Encoding of the fixtures, nullptr = plain
+int windowBits = 0;                  // zlib format of bodyEncoding
+int wifiStatus = WL_CONNECTED;
+sim::NetStats stats = {};
+unsigned long virtualMs = 0;
+const auto startTime = std::chrono::steady_clock::now();
+
+unsigned long long elapsedUs() {
+    auto real = std::chrono::steady_clock::now() - startTime;
+    return std::chrono::duration_cast<std::chrono::microseconds>(real).count() +
+           (unsigned long long)virtualMs * 1000;
+}
+
+const Fixture* findFixture(const char* path, size_t length) {
+    const Fixture* best = nullptr;
+    for (const Fixture& f : fixtures) {
+        if (length >= f.prefix.size() && f.prefix.compare(0, f.prefix.size(), path, f.prefix.size()) == 0 &&
+            (!best || f.prefix.size() > best->prefix.size())) {
+            best = &f;
+        }
+    }
+    return best;
+}
+
+// windowBits picks the format: 15 + 16 gzip, 15 zlib, -15 raw deflate
+std::string compress(const std::string& data, int bits) {
+    z_stream z = {};
+    deflateInit2(&z, Z_BEST_COMPRESSION, Z_DEFLATED, bits, 8, Z_DEFAULT_STRATEGY);
+    std::string out(deflateBound(&z, data.size()), '\0');
+    z.next_in = (Bytef*)data.data();
+    z.avail_in = data.size();
+    z.next_out = (Bytef*)&out[0];
+    z.avail_out = out.size();
+    deflate(&z, Z_FINISH);
+    out.resize(z.total_out);
+    deflateEnd(&z);
+    return out;
+}
+
+std::string buildResponse(const char* status, const std::string& plain) {
+    std::string response = std::string("HTTP/1.1 ") + status + "\r\nContent-Type: application/json\r\n";
+    std::string body = plain;
+    if (bodyEncoding) {
+        body = compress(plain, windowBits);
+        response += std::string("Content-Encoding: ") + bodyEncoding + "\r\n";
+    }
+    if (chunkSize == 0) {
+        return response + "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+    }
+    response += "Transfer-Encoding: chunked\r\n\r\n";
+    for (size_t i = 0; i < body.size(); i += chunkSize) {
+        size_t n = std::min(chunkSize, body.size() - i);
+        char size[16];
+        snprintf(size, sizeof(size), "%zx\r\n", n);
+        response += size + body.substr(i, n) + "\r\n";
+    }
+    return response + "0\r\n\r\n";
+}
+
+std::string notFound;
+
+void rebuildResponses() {
+    for (Fixture& f : fixtures) f.response = buildResponse("200 OK", f.body);
+    notFound = buildResponse("404 Not Found", "not found");
+}
+
+}  // namespace
+
+unsigned long millis() { return (unsigned long)(elapsedUs() / 1000); }
+unsigned long micros() { return (unsigned long)elapsedUs(); }
+void delay(unsigned long ms) { virtualMs += ms; }
+void yield() {}
+
+long random(long max) { return max > 0 ? rand() % max : 0; }
+long random(long min, long max) { return min + random(max - min); }
+void randomSeed(unsigned long seed) { srand(seed); }
+
+int HardwareSerial::available() {
+    static bool nonBlocking = false;
+    if (!nonBlocking) {
+        fcntl(0, F_SETFL, fcntl(0, F_GETFL) | O_NONBLOCK);
+        nonBlocking = true;
+    }
+    int c = getchar();
+    if (c == EOF) {
+        clearerr(stdin);
+        return 0;
+    }
+    ungetc(c, stdin);
+    return 1;
+}
+
+int HardwareSerial::read() {
+    if (!available()) return -1;
+    return getchar();
+}
+
+// --- Simulated network -----------------------------------------------------
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+    stats.dnsLookups++;
+    in_addr address = {};
+    if (port != 80 && inet_pton(AF_INET, strcmp(host, "localhost") == 0 ? "127.0.0.1" : host, &address) == 1) {
+        return connect(IPAddress(address.s_addr), port);
+    }
+    return connect(IPAddress(127, 0, 0, 1), port);
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port) {
+    if (wifiStatus != WL_CONNECTED) return 0;
+    stop();
+    if (port != 80) {
+        // Anything but HTTP goes out for real, e.g. to a local mosquitto
+        socket = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = (uint32_t)ip;
+        if (socket < 0 || ::connect(socket, (sockaddr*)&address, sizeof(address)) != 0) {
+            stop();
+            return 0;
+        }
+        open = true;
+        stats.connects++;
+        return 1;
+    }
+    open = true;
+    stats.connects++;
+    return 1;
+}
+
+void WiFiClient::stop() {
+    if (socket >= 0) close(socket);
+    socket = -1;
+    open = false;
+    requestLength = 0;
+    response = nullptr;
+    position = 0;
+}
+
+uint8_t WiFiClient::connected() {
+    if (socket >= 0) {
+        char c;
+        ssize_t n = recv(socket, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+        return n > 0 || (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+    }
+    return open || available() > 0;
+}
+
+size_t WiFiClient::write(uint8_t c) { return write(&c, 1); }
+
+size_t WiFiClient::write(const uint8_t* buffer, size_t size) {
+    if (socket >= 0) {
+        ssize_t n = send(socket, buffer, size, MSG_NOSIGNAL);
+        return n > 0 ? n : 0;
+    }
+    if (!open) return 0;
+    for (size_t i = 0; i < size; i++) {
+        if (requestLength < sizeof(request)) request[requestLength++] = buffer[i];
+        if (requestLength >= 4 && memcmp(request + requestLength - 4, "\r\n\r\n", 4) == 0) {
+            handleRequest();
+        }
+    }
+    return size;
+}
+
+// Answer a complete request from the fixtures, keeping the connection open.
+// Pipelining is not simulated: a new request replaces any unread response.
+void WiFiClient::handleRequest() {
+    const char* end = request + requestLength;
+    const char* path = (const char*)memchr(request, ' ', requestLength);
+    path = path ? path + 1 : end;
+    const char* pathEnd = (const char*)memchr(path, ' ', end - path);
+    size_t pathLength = (pathEnd ? pathEnd : end) - path;
+    requestLength = 0;
+    stats.requests++;
+
+    const Fixture* fixture = findFixture(path, pathLength);
+    response = fixture ? &fixture->response : &notFound;
+    position = 0;
+}
+
+int WiFiClient::available() {
+    if (socket >= 0) {
+        int n = 0;
+        return ioctl(socket, FIONREAD, &n) == 0 ? n : 0;
+    }
+    return response ? (int)(response->size() - position) : 0;
+}
+
+int WiFiClient::read() {
+    if (socket >= 0) {
+        // delay() doesn't pass real time, so wait a moment here for the peer
+        uint8_t c;
+        if (recv(socket, &c, 1, MSG_DONTWAIT) == 1) return c;
+        pollfd ready = {socket, POLLIN, 0};
+        ::poll(&ready, 1, 1);
+        return -1;
+    }
+    if (available() <= 0) return -1;
+    stats.bytesSent++;
+    return (uint8_t)(*response)[position++];
+}
+
+int WiFiClient::read(uint8_t* buffer, size_t size) {
+    if (socket >= 0) {
+        ssize_t n = recv(socket, buffer, size, MSG_DONTWAIT);
+        return n > 0 ? (int)n : -1;
+    }
+    size_t n = std::min(size, (size_t)available());
+    if (n) memcpy(buffer, response->data() + position, n);
+    position += n;
+    stats.bytesSent += n;
+    return (int)n;
+}
+
+int WiFiClient::peek() {
+    if (socket >= 0) {
+        uint8_t c;
+        return recv(socket, &c, 1, MSG_PEEK | MSG_DONTWAIT) == 1 ? c : -1;
+    }
+    return available() > 0 ? (uint8_t)(*response)[position] : -1;
+}
+
+void WiFiServer::begin() {
+    listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    int on = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(listener, (sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 4) != 0) {
+        fprintf(stderr, "Cannot listen on port %u: %s\n", port, strerror(errno));
+        close(listener);
+        listener = -1;
+        return;
+    }
+    fcntl(listener, F_SETFL, fcntl(listener, F_GETFL) | O_NONBLOCK);
+}
+
+// delay() only advances virtual time here, so give the request a moment of
+// real time to arrive before handing the connection to the firmware
+WiFiClient WiFiServer::available() {
+    WiFiClient client;
+    if (listener < 0) return client;
+    int fd = accept(listener, nullptr, nullptr);
+    if (fd < 0) return client;
+    pollfd ready = {fd, POLLIN, 0};
+    ::poll(&ready, 1, 200);
+    client.socket = fd;
+    client.open = true;
+    return client;
+}
+
+wl_status_t WiFiClass::status() { return (wl_status_t)wifiStatus; }
+
+// The simulated access point answers at once when it is up
+void WiFiClass::begin(const char*, const char*) {
+    if (wifiStatus == WL_CONNECTED) fireEvent(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+}
+
+// Like the IDF, reports leaving even if the station wasn't associated
+bool WiFiClass::disconnect(bool, bool) {
+    fireEvent(ARDUINO_EVENT_WIFI_STA_DISCONNECTED, WIFI_REASON_ASSOC_LEAVE);
+    return true;
+}
+
+void WiFiClass::fireEvent(arduino_event_id_t event, uint8_t reason) {
+    if (!eventHandler) return;
+    arduino_event_info_t info = {};
+    info.wifi_sta_disconnected.reason = reason;
+    eventHandler(event, info);
+}
+
+int WiFiClass::hostByName(const char*, IPAddress& result) {
+    if (wifiStatus != WL_CONNECTED) return 0;
+    stats.dnsLookups++;
+    result = IPAddress(127, 0, 0, 1);
+    return 1;
+}
+
+bool HTTPClient::begin(const String& url) {
+    std::string u = url.c_str();
+    size_t hostStart = u.find("://");
+    hostStart = hostStart == std::string::npos ? 0 : hostStart + 3;
+    size_t pathStart = u.find('/', hostStart);
+    host = u.substr(hostStart, pathStart - hostStart);
+    path = pathStart == std::string::npos ? "/" : u.substr(pathStart);
+    return true;
+}
+
+int HTTPClient::GET() {
+    if (!client.connect(host.c_str(), 80)) return HTTPC_ERROR_CONNECTION_REFUSED;
+    std::string request = "GET " + path + " HTTP/1.0\r\nHost: " + host + "\r\n\r\n";
+    client.write((const uint8_t*)request.data(), request.size());
+
+    char line[128];
+    size_t n = client.readBytesUntil('\n', line, sizeof(line) - 1);
+    line[n] = '\0';
+    int code = 0;
+    if (sscanf(line, "HTTP/%*d.%*d %d", &code) != 1) return HTTPC_ERROR_NO_HTTP_SERVER;
+    size = -1;
+    while ((n = client.readBytesUntil('\n', line, sizeof(line) - 1)) > 1) {
+        line[n] = '\0';
+        if (strncasecmp(line, "Content-Length:", 15) == 0) size = atoi(line + 15);
+    }
+    return code;
+}
+
+String HTTPClient::getString() {
+    String body;
+    int c;
+    while ((c = client.read()) >= 0) body += (char)c;
+    return body;
+}
+
+// --- Controls ----------------------------------------------------------------
+
+namespace sim {
+
+bool addFixture(const char* pathPrefix, const char* file) {
+    FILE* f = fopen(file, "rb");
+    if (!f) return false;
+    std::string body;
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) body.append(buffer, n);
+    fclose(f);
+    fixtures.push_back({pathPrefix, body, std::string()});
+    rebuildResponses();
+    return true;
+}
+
+void setChunkSize(size_t size) {
+    chunkSize = size;
+    rebuildResponses();
+}
+
+void setGzip(bool enabled) {
+    bodyEncoding = enabled ? "gzip" : nullptr;
+    windowBits = 15 + 16;
+    rebuildResponses();
+}
+
+void setDeflate(bool enabled, bool zlibWrapped) {
+    bodyEncoding = enabled ? "deflate" : nullptr;
+    windowBits = zlibWrapped ? 15 : -15;
+    rebuildResponses();
+}
+
+void setWiFiStatus(int status) {
+    bool wasConnected = wifiStatus == WL_CONNECTED;
+    wifiStatus = status;
+    if (wasConnected && status != WL_CONNECTED) {
+        WiFi.fireEvent(ARDUINO_EVENT_WIFI_STA_DISCONNECTED, WIFI_REASON_BEACON_TIMEOUT);
+    }
+}
+NetStats netStats() { return stats; }
+void resetNetStats() { stats = {}; }
+unsigned long delayedMs() { return virtualMs; }
+
+bool writePPM(const char* path, const CRGB* leds, int width, int height, int scale) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    fprintf(f, "P6\n%d %d\n255\n", width * scale, height * scale);
+    for (int y = 0; y < height; y++) {  // Row 0 is the top of the text
+        for (int sy = 0; sy < scale; sy++) {
+            for (int x = 0; x < width; x++) {
+                const CRGB& c = leds[xyTable[x][y]];
+                for (int sx = 0; sx < scale; sx++) fwrite(c.raw, 1, 3, f);
+            }
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+void printFrame(const CRGB* leds, int width, int height) {
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const CRGB& c = leds[xyTable[x][y]];
+            printf("\x1b[48;2;%d;%d;%dm  ", c.r, c.g, c.b);
+        }
+        printf("\x1b[0m\n");
+    }
+}
+
+}  // namespace sim
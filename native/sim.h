@@ -0,0 +1,49 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+// Controls for the host simulation behind the shims
+namespace sim {
+
+// Serve body (read from a file) for request paths starting with pathPrefix
+bool addFixture(const char* pathPrefix, const char* file);
+
+// 0 sends fixtures with Content-Length, otherwise chunked in pieces of this size
+void setChunkSize(size_t size);
+
+// Send fixtures gzip-compressed with Content-Encoding: gzip, whether or not
+// the request asked for it
+void setGzip(bool enabled);
+
+// Same with Content-Encoding: deflate, zlib-wrapped as the HTTP spec says
+// or the raw stream some servers send
+void setDeflate(bool enabled, bool zlibWrapped = true);
+
+// Network state seen by the firmware. Dropping the link fires a disconnect
+// event; the next WiFi.begin() reconnects if the status is WL_CONNECTED.
+void setWiFiStatus(int status);
+
+// Counters of the simulated network
+struct NetStats {
+    unsigned long dnsLookups;
+    unsigned long connects;
+    unsigned long requests;
+    unsigned long bytesSent;     // Response bytes handed to the firmware
+};
+NetStats netStats();
+void resetNetStats();
+
+// Virtual milliseconds added by delay() so far
+unsigned long delayedMs();
+
+// Framebuffer output: write one frame as a binary PPM, scaled up by scale
+bool writePPM(const char* path, const CRGB* leds, int width, int height, int scale);
+
+// Print one frame to the terminal with 24-bit colour blocks
+void printFrame(const CRGB* leds, int width, int height);
+
+}  // namespace sim
+
+#endif // SIM_H
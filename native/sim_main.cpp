@@ -0,0 +1,194 @@
+// Host simulation of the display firmware.
+//
+//   program bench [iterations]          render/parse benchmarks
+//   program render [options]            fetch fixtures and scroll the ticker
+//       --every N      print every Nth frame to the terminal (default 6)
+//       --ppm FILE     write frame --frame N (default 0) as a PPM instead
+//   program soak [cycles]               steady-state run (default 2000 cycles of
+//       fetch, compose, scroll and status reply); fails if the heap is
+//       touched after warm-up
+//   program serve [port] [requests]     fetch fixtures and run the status
+//       server on localhost (default 8080) until it has answered that many
+//       requests (default: forever), e.g. curl localhost:8080/status
+//   program mqtt [host] [port] [batches]
+//                                       fetch fixtures, queue that many
+//       telemetry batches (default 3) and publish them to a broker
+//       (default localhost:1883); fails if any is left unsent
+//
+// Fixtures are read from native/fixtures, or from $SIM_FIXTURES.
+#include <string>
+#include <unistd.h>
+#include "bench.h"
+#include "display.h"
+#include "fetch.h"
+#include "heap_tracker.h"
+#include "logger.h"
+#include "mqtt_publisher.h"
+#include "settings.h"
+#include "sim.h"
+#include "status_server.h"
+#include "telemetry.h"
+#include "ticker.h"
+
+// Unit tests (test/) link the same sources and bring their own main
+#ifndef PIO_UNIT_TESTING
+
+namespace {
+
+bool loadFixtures() {
+    const char* dir = getenv("SIM_FIXTURES");
+    std::string base = dir ? dir : "native/fixtures";
+    bool ok = sim::addFixture(API_PATH PM_SENSOR_ID "/", (base + "/sensor_" PM_SENSOR_ID ".json").c_str());
+    // Other PM stations are optional; one without a fixture gets a 404
+    for (const char* id : PM_SENSOR_IDS) {
+        std::string path = std::string(API_PATH) + id + "/";
+        sim::addFixture(path.c_str(), (base + "/sensor_" + id + ".json").c_str());
+    }
+    ok &= sim::addFixture(API_PATH TEMP_SENSOR_ID "/", (base + "/sensor_" TEMP_SENSOR_ID ".json").c_str());
+    ok &= sim::addFixture("/v1/forecast", (base + "/weather.json").c_str());
+    sim::addFixture("/airrohr/v1/filter/", (base + "/area.json").c_str());  // For PM_AREA_MODE
+    if (!ok) fprintf(stderr, "Could not read fixtures from %s\n", base.c_str());
+    return ok;
+}
+
+const char* ppmPath = nullptr;
+int ppmFrame = 0;
+int printEvery = 6;
+int frameNumber = 0;
+
+void onShow(const CRGB* data, int, uint8_t) {
+    if (ppmPath) {
+        if (frameNumber == ppmFrame) sim::writePPM(ppmPath, data, MATRIX_WIDTH, MATRIX_HEIGHT, 8);
+    } else if (printEvery > 0 && frameNumber % printEvery == 0) {
+        printf("frame %d\n", frameNumber);
+        sim::printFrame(data, MATRIX_WIDTH, MATRIX_HEIGHT);
+    }
+    frameNumber++;
+}
+
+int runRender() {
+    addLedControllers();
+
+    PM_AREA_MODE ? fetchAreaData() : fetchPMData();
+    fetchSensorData(TEMP_SENSOR_ID, false);
+    fetchWeatherData();
+
+    char message[MAX_MESSAGE_LENGTH];
+    composeTickerMessage(netReadings, message, sizeof(message));
+    FastLED.setShowHook(onShow);
+    scrollMessage(message, CRGB(255, 20, 147));
+    return 0;
+}
+
+// After a warm-up, whole update cycles must not allocate: on the device
+// every allocation that comes and goes can leave a hole, and over months
+// the largest free block shrinks until a fetch fails
+int runSoak(long cycles) {
+    addLedControllers();
+    Serial.mute(true);
+    static SeqLock<SensorSnapshot> published;
+    static SensorSnapshot readings;
+    static TickerComposer ticker;
+    static char json[STATUS_RESPONSE_SIZE];
+    long warmup = cycles / 10 + 1;
+    size_t baseline = 0;
+    unsigned long baselineAllocations = 0;
+    unsigned long now = 0;
+
+    for (long cycle = 0; cycle < cycles + warmup; cycle++) {
+        if (cycle == warmup) {
+            baseline = heap::current();
+            baselineAllocations = heap::allocations();
+        }
+        // Forget the last readings, so every poll takes the update path
+        lastPMTimestamp[0] = lastTempTimestamp[0] = lastWeatherTime[0] = '\0';
+        netReadings.pmStations = 0;
+
+        PM_AREA_MODE ? fetchAreaData() : fetchPMData();
+        fetchSensorData(TEMP_SENSOR_ID, false);
+        fetchWeatherData();
+        published.write(netReadings);
+        published.read(readings);
+        ticker.update(readings, cycle % 5 ? DATA_LIVE : DATA_STALE);
+        scroller.startColumns(ticker.columns(), ticker.width(), CRGB::White);
+        for (int frame = 0; frame < 50; frame++) scroller.tick(now += SCROLL_FRAME_MS);
+        buildStatusJson(readings, json, sizeof(json));
+        LogLine line;
+        telemetry.printSummary(line);
+    }
+    Serial.mute(false);
+
+    long grown = (long)heap::current() - (long)baseline;
+    unsigned long allocations = heap::allocations() - baselineAllocations;
+    printf("soak: %ld cycles after %ld warm-up: %lu allocations, live heap %+ld bytes\n",
+           cycles, warmup, allocations, grown);
+    return allocations == 0 && grown == 0 ? 0 : 1;
+}
+
+int runServe(uint16_t port, long requests) {
+    PM_AREA_MODE ? fetchAreaData() : fetchPMData();
+    fetchSensorData(TEMP_SENSOR_ID, false);
+    fetchWeatherData();
+
+    static SeqLock<SensorSnapshot> published;
+    published.write(netReadings);
+    static StatusServer server(port);
+    server.begin(&published);
+    printf("Serving status on http://localhost:%u/status\n", port);
+    fflush(stdout);
+
+    for (long served = 0; requests <= 0 || served < requests;) {
+        if (server.poll()) served++;
+        else usleep(1000);
+    }
+    return 0;
+}
+
+int runMqtt(const char* host, uint16_t port, long batches) {
+    PM_AREA_MODE ? fetchAreaData() : fetchPMData();
+    fetchSensorData(TEMP_SENSOR_ID, false);
+    fetchWeatherData();
+
+    mqttPublisher.begin(host, port);
+    for (long i = 0; i < batches; i++) mqttPublisher.sample(netReadings, millis());
+    bool flushed = mqttPublisher.flush();
+    MqttStats stats = mqttPublisher.stats();
+    printf("mqtt: %s:%u %s: %lu published, %u queued, %lu dropped, %lu failures\n", host, port,
+           mqttPublisher.topic(), (unsigned long)stats.published, stats.queued,
+           (unsigned long)stats.dropped, (unsigned long)stats.failures);
+    return flushed ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (!loadFixtures()) return 1;
+    std::string mode = argc > 1 ? argv[1] : "bench";
+
+    if (mode == "bench") {
+        return runBenchmarks(argc > 2 ? atoi(argv[2]) : 1000);
+    }
+    if (mode == "render") {
+        for (int i = 2; i + 1 < argc; i += 2) {
+            std::string option = argv[i];
+            if (option == "--ppm") ppmPath = argv[i + 1];
+            else if (option == "--frame") ppmFrame = atoi(argv[i + 1]);
+            else if (option == "--every") printEvery = atoi(argv[i + 1]);
+        }
+        return runRender();
+    }
+    if (mode == "soak") {
+        return runSoak(argc > 2 ? atol(argv[2]) : 2000);
+    }
+    if (mode == "serve") {
+        return runServe(argc > 2 ? atoi(argv[2]) : 8080, argc > 3 ? atol(argv[3]) : 0);
+    }
+    if (mode == "mqtt") {
+        return runMqtt(argc > 2 ? argv[2] : "localhost", argc > 3 ? atoi(argv[3]) : MQTT_PORT,
+                       argc > 4 ? atol(argv[4]) : 3);
+    }
+    fprintf(stderr, "usage: %s [bench [iterations] | render [--every N] [--ppm FILE [--frame N]] | soak [cycles] | serve [port] [requests] | mqtt [host] [port] [batches]]\n",
+            argv[0]);
+    return 1;
+}
+#endif // PIO_UNIT_TESTING
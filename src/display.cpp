@@ -0,0 +1,259 @@
+#include "display.h"
+#include "telemetry.h"
+#include "power.h"
+#include "logger.h"
+#include "power_mode.h"
+
+// Double buffering: the renderer draws into leds[] (back buffer) while the
+// controllers send frontBuffer. showFrame() copies one into the other once
+// the previous frame is out.
+CRGB leds[NUM_LEDS];
+static CRGB frontBuffer[NUM_LEDS];
+
+// Output runs in its own task on the device; the host build shows inline
+#if defined(ESP32) && LED_ASYNC_OUTPUT
+#define ASYNC_OUTPUT 1
+#define LED_TASK_CORE 1          // Same core as loop(), which it preempts only to start a frame
+#define LED_TASK_STACK 4096
+#define LED_TASK_PRIORITY 2      // Above loop()
+
+static TaskHandle_t outputTask = nullptr;
+static SemaphoreHandle_t outputIdle = nullptr;
+
+// show() blocks until the RMT driver has clocked the frame out; waiting
+// here instead of in loop() lets the next frame render meanwhile
+static void ledOutputTask(void* parameter) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        powerMode.beginOutput();
+        unsigned long start = micros();
+        FastLED.show();
+        telemetry.recordShow(micros() - start);
+        powerMode.endOutput();
+        xSemaphoreGive(outputIdle);
+    }
+}
+#endif
+
+// Register the LED outputs with FastLED
+void addLedControllers() {
+#if PANEL_PARALLEL && PANEL_COUNT > 1
+    static_assert(PANEL_COUNT <= 4, "Only LED_PIN to LED_PIN_4 are defined");
+    // Separate controllers are sent in parallel by the ESP32 RMT driver
+    FastLED.addLeds<WS2812B, LED_PIN, GRB>(frontBuffer, Matrix::PANEL_LEDS);
+    FastLED.addLeds<WS2812B, LED_PIN_2, GRB>(frontBuffer + Matrix::PANEL_LEDS, Matrix::PANEL_LEDS);
+#if PANEL_COUNT > 2
+    FastLED.addLeds<WS2812B, LED_PIN_3, GRB>(frontBuffer + 2 * Matrix::PANEL_LEDS, Matrix::PANEL_LEDS);
+#endif
+#if PANEL_COUNT > 3
+    FastLED.addLeds<WS2812B, LED_PIN_4, GRB>(frontBuffer + 3 * Matrix::PANEL_LEDS, Matrix::PANEL_LEDS);
+#endif
+#else
+    FastLED.addLeds<WS2812B, LED_PIN, GRB>(frontBuffer, NUM_LEDS);
+#endif
+
+#ifdef ASYNC_OUTPUT
+    if (!outputTask) {
+        outputIdle = xSemaphoreCreateBinary();
+        xSemaphoreGive(outputIdle);
+        xTaskCreatePinnedToCore(ledOutputTask, "leds", LED_TASK_STACK, nullptr,
+                                LED_TASK_PRIORITY, &outputTask, LED_TASK_CORE);
+    }
+#endif
+}
+
+
+// Function to test the display
+void testDisplay() {
+    //Serial.println("Running display test...");
+    for (int i = 0; i < 3; i++) {
+        // Turn all LEDs red
+        fill_solid(leds, NUM_LEDS, CRGB::Yellow);
+        showFrame();
+        delay(50);
+        
+        // Turn all LEDs off
+        fill_solid(leds, NUM_LEDS, CRGB::Black);
+        showFrame();
+        delay(50);
+    }
+
+    delay(100);
+    
+    LOG_INFO("Display test complete.");
+}
+
+// Function to set a pixel in the matrix
+void setMatrixPixel(int x, int y, CRGB color) {
+    if (x >= 0 && x < MATRIX_WIDTH && y >= 0 && y < MATRIX_HEIGHT) {
+        leds[xyTable[x][y]] = color;
+    }
+}
+
+// FNV-1a over the framebuffer and brightness of the last pushed frame
+static uint32_t lastFrameHash = 0;
+static bool frameShown = false;
+
+static uint32_t frameHash(uint8_t brightness) {
+    if (brightness == 0) return 0;  // Blank, whatever leds[] holds
+    uint32_t hash = 2166136261u;
+    const uint8_t* bytes = (const uint8_t*)leds;
+    for (size_t i = 0; i < sizeof(leds); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return (hash ^ brightness) * 16777619u;
+}
+
+// Push leds[] to the strip unless it matches the last pushed frame
+bool showFrame(bool force) {
+    uint8_t brightness = powerManager.frameBrightness(leds, NUM_LEDS);
+    uint32_t hash = frameHash(brightness);
+    if (!force && frameShown && hash == lastFrameHash) return false;
+
+    // The front buffer and brightness belong to the output until it is idle
+#ifdef ASYNC_OUTPUT
+    xSemaphoreTake(outputIdle, portMAX_DELAY);
+#endif
+    memcpy(frontBuffer, leds, sizeof(frontBuffer));
+    FastLED.setBrightness(brightness);
+#ifdef ASYNC_OUTPUT
+    xTaskNotifyGive(outputTask);
+#else
+    powerMode.beginOutput();
+    unsigned long showStart = micros();
+    FastLED.show();
+    telemetry.recordShow(micros() - showStart);
+    powerMode.endOutput();
+#endif
+    telemetry.recordPower(powerManager.lastCurrent());
+    lastFrameHash = hash;
+    frameShown = true;
+    return true;
+}
+
+// Start scrolling a new message from the right edge
+void Scroller::start(const char* message, CRGB color) {
+    LOG_DEBUG("Scrolling message: %s", message);
+
+    // Rasterize once; every frame then only copies the visible window
+    totalWidth = rasterizeText(message, columns, sizeof(columns));
+    begin(color);
+}
+
+// Same for text that is already rasterized (one byte per column)
+void Scroller::startColumns(const uint8_t* strip, int width, CRGB color) {
+    totalWidth = width < (int)sizeof(columns) ? width : sizeof(columns);
+    memcpy(columns, strip, totalWidth);
+    begin(color);
+}
+
+// Position a freshly loaded message: centered if it fits, else off the right edge
+void Scroller::begin(CRGB color) {
+    textColor = color;
+
+    // The last column is letter spacing, so it may fall off the edge
+    isStatic = holdTime > 0 && totalWidth - 1 <= MATRIX_WIDTH;
+    staticDrawn = false;
+    xStart = isStatic ? (MATRIX_WIDTH - (totalWidth - 1)) / 2 : MATRIX_WIDTH;
+    lastFrameTime = millis() - framePeriod;  // Draw the first frame right away
+    lastShowTime = lastFrameTime - minShowInterval;
+    done = false;
+}
+
+// Show a message once the current pass has finished
+void Scroller::queue(const char* message, CRGB color) {
+    strncpy(pendingText, message, sizeof(pendingText) - 1);
+    pendingText[sizeof(pendingText) - 1] = '\0';
+    pendingColor = color;
+    hasPending = true;
+}
+
+// Draw the next frame if it is due. Returns true when a frame was drawn.
+bool Scroller::tick(unsigned long now) {
+    if (done) {
+        if (!hasPending) return false;
+        hasPending = false;
+        start(pendingText, pendingColor);
+    }
+    if (isStatic) {
+        // Pushed once, then left alone until the hold time is up
+        if (!staticDrawn) {
+            staticDrawn = true;
+            lastFrameTime = now;
+            return drawFrame();
+        }
+        if (now - lastFrameTime >= holdTime) done = true;
+        return false;
+    }
+
+    if (now - lastFrameTime < framePeriod) return false;
+
+    // Keep a fixed cadence, but resync instead of bursting to catch up
+    // when something held up the loop for more than a frame.
+    lastFrameTime += framePeriod;
+    if (now - lastFrameTime >= framePeriod) {
+        lastFrameTime = now;
+        telemetry.recordLateFrame();
+    }
+
+    // Over the FPS cap this column is skipped, the next one will be shown.
+    // Measured between scheduled times, so a loop that wakes a little late
+    // doesn't push the next frame under the cap.
+    bool drawn = false;
+    if (lastFrameTime - lastShowTime >= minShowInterval) {
+        lastShowTime = lastFrameTime;
+        drawn = drawFrame();
+    }
+
+    if (--xStart <= -totalWidth) {
+        done = true;
+    }
+    return drawn;
+}
+
+// Render the current position and push it if anything changed
+bool Scroller::drawFrame() {
+    unsigned long renderStart = micros();
+    renderFrame();
+    uint32_t renderTime = micros() - renderStart;
+    if (!showFrame()) {
+        telemetry.recordSkippedFrame();
+        return false;
+    }
+    telemetry.recordFrame(renderTime);
+    return true;
+}
+
+// Copy the 32 visible columns into leds[] through the XY table
+void Scroller::renderFrame() {
+    for (int x = 0; x < MATRIX_WIDTH; x++) {
+        int column = x - xStart;
+        uint8_t bits = (column >= 0 && column < totalWidth) ? columns[column] : 0;
+        const uint16_t* index = xyTable[x];
+        for (int y = 0; y < MATRIX_HEIGHT; y++) {
+            leds[index[y]] = (bits & (1 << y)) ? textColor : CRGB(CRGB::Black);
+        }
+    }
+}
+
+Scroller scroller;
+
+// Scroll a message to completion. Blocks, so not for use from loop().
+void scrollMessage(const char* message, CRGB color) {
+    scroller.start(message, color);
+    while (!scroller.isIdle()) {
+        scroller.tick(millis());
+        delay(1);
+    }
+}
+
+void updateDisplay() {
+    // For testing, just rotate the colors
+    CRGB temp = leds[0];
+    for(int i = 0; i < NUM_LEDS-1; i++) {
+        leds[i] = leds[i+1];
+    }
+    leds[NUM_LEDS-1] = temp;
+    showFrame();
+    delay(50);
+}
@@ -0,0 +1,631 @@
+#include <WiFi.h>
+#include <ArduinoJson.h>
+#include "fetch.h"
+#include "settings.h"
+#include "http_session.h"
+#include "json_arena.h"
+#include "telemetry.h"
+#include "logger.h"
+#include "poll_scheduler.h"  // parseTimestamp()
+
+bool initialFetchDone = false;  // Flag to track initial fetch
+
+SensorSnapshot netReadings;
+
+// OpenMeteo API endpoint for Chiang Mai
+const char* weatherHost = "api.open-meteo.com";
+const char* weatherPath = "/v1/forecast?latitude=18.7883&longitude=98.9853"
+                      "&current=temperature_2m,weathercode,pressure_msl"
+                      "&daily=weathercode,temperature_2m_max,temperature_2m_min"
+                      "&timezone=Asia%2FBangkok"
+                      "&forecast_days=2";
+
+// Fields kept from the OpenMeteo reply; everything else is skipped while parsing
+const JsonDocument& weatherFilter() {
+    static StaticJsonDocument<256> filter;
+    if (filter.isNull()) {
+        JsonObject current = filter.createNestedObject("current");
+        current["time"] = true;
+        current["temperature_2m"] = true;
+        current["pressure_msl"] = true;
+        current["weathercode"] = true;
+        JsonObject daily = filter.createNestedObject("daily");
+        daily["temperature_2m_max"] = true;
+        daily["temperature_2m_min"] = true;
+        daily["weathercode"] = true;
+    }
+    return filter;
+}
+
+// Fields kept from a sensor.community reading
+const JsonDocument& sensorFilter() {
+    static StaticJsonDocument<256> filter;
+    if (filter.isNull()) {
+        filter["timestamp"] = true;
+        JsonObject location = filter.createNestedObject("location");
+        location["latitude"] = true;
+        location["longitude"] = true;
+        location["altitude"] = true;
+        filter["sensordatavalues"][0]["value_type"] = true;
+        filter["sensordatavalues"][0]["value"] = true;
+    }
+    return filter;
+}
+
+static const char* const pmStations[] = PM_SENSOR_IDS;
+static const int PM_STATION_COUNT = sizeof(pmStations) / sizeof(pmStations[0]);
+static_assert(PM_STATION_COUNT <= 5, "Up to 5 PM_SENSOR_IDS; each keeps a connection open");
+
+// A persistent connection to the Sensor.Community API
+struct ApiSession : HttpSession {
+    ApiSession() : HttpSession(API_HOST) {}
+};
+
+// One connection per PM station, so all requests can be in flight together.
+// The temperature sensor and the area feed use the first one; they are
+// fetched one after another on the network task, never during a PM round.
+ApiSession stationSessions[PM_STATION_COUNT];
+HttpSession& sensorSession = stationSessions[0];
+HttpSession weatherSession(weatherHost);
+
+// Time of the OpenMeteo "current" block last stored
+char lastWeatherTime[20];
+
+// Function to fetch weather data from OpenMeteo
+FetchResult fetchWeatherData() {
+    LOG_INFO("Fetching weather data...");
+    FetchRecorder fetch(SOURCE_WEATHER);
+
+    weatherSession.setTimeout(HTTP_TIMEOUT);
+    weatherSession.setCompression(HTTP_COMPRESSION);
+    int statusCode = weatherSession.get(weatherPath);
+    if (statusCode < 0) {
+        LOG_ERROR("Connection to weather server failed!");
+        fetch.error = statusCode;
+        return FETCH_ERROR;
+    }
+    if (statusCode != 200) {
+        LOG_ERROR("Unexpected HTTP status: %d", statusCode);
+        weatherSession.close();
+        fetch.error = statusCode;
+        return FETCH_ERROR;
+    }
+
+    // Parse JSON response from the socket, keeping only the fields we use
+    ArenaJsonDocument doc(WEATHER_DOC_SIZE);
+    DeserializationError error = deserializeJson(doc, weatherSession.body(), DeserializationOption::Filter(weatherFilter()));
+    weatherSession.end();
+
+    if (error) {
+        LOG_ERROR("JSON parsing error: %s", error.c_str());
+        fetch.error = FETCH_ERROR_PARSE;
+        return FETCH_ERROR;
+    }
+    fetch.ok = true;
+
+    // The current block is refreshed every 15 minutes; skip it until then
+    const char* time = doc["current"]["time"] | "";
+    if (time[0] != '\0' && strcmp(time, lastWeatherTime) == 0) {
+        LOG_INFO("Weather unchanged since last poll");
+        return FETCH_UNCHANGED;
+    }
+    strncpy(lastWeatherTime, time, sizeof(lastWeatherTime) - 1);
+
+    // Extract weather data
+    netReadings.currentTemp = doc["current"]["temperature_2m"].as<float>();
+    netReadings.currentPressure = doc["current"]["pressure_msl"].as<float>();
+    netReadings.currentWeatherCode = doc["current"]["weathercode"].as<int>();
+    
+    netReadings.tomorrowMaxTemp = doc["daily"]["temperature_2m_max"][1].as<float>();
+    netReadings.tomorrowMinTemp = doc["daily"]["temperature_2m_min"][1].as<float>();
+    netReadings.tomorrowWeatherCode = doc["daily"]["weathercode"][1].as<int>();
+    netReadings.weatherVersion++;
+    netReadings.weatherFetchedAt = millis();
+    return FETCH_UPDATED;
+}
+
+// Function to convert UTC timestamp to Thailand time (UTC+7)
+const char* adjustToLocalTime(const char* timestamp) {
+    // Parse timestamp (format: "2025-02-16 03:11:56")
+    int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+    sscanf(timestamp, "%d-%d-%d %d:%d:%d", &year, &month, &day, &hour, &minute, &second);
+    
+    // Add 7 hours for Thailand timezone
+    hour += 7;
+    
+    // Handle day changes
+    if (hour >= 24) {
+        hour -= 24;
+        day += 1;
+    }
+    
+    // Format the adjusted time; a malformed timestamp is cut to fit
+    char localTime[32];
+    snprintf(localTime, sizeof(localTime), "%04d-%02d-%02d %02d:%02d", year, month, day, hour, minute);
+    strncpy(netReadings.localTime, localTime, sizeof(netReadings.localTime) - 1);
+    netReadings.localTime[sizeof(netReadings.localTime) - 1] = '\0';
+    return netReadings.localTime;
+}
+
+History pmHistory;
+History temperatureHistory;
+
+static_assert(SPARKLINE_COLUMNS <= HISTORY_SPARKLINE_MAX, "Sparkline wider than History can draw");
+
+#define PM_TREND_THRESHOLD 20  // 2 ug/m3 from the 1 h mean counts as rising/falling
+
+// Copy the history figures the ticker shows into the snapshot
+static void updateHistoryStats(bool isPMSensor) {
+    if (isPMSensor) {
+        netReadings.pmMeanHour = pmHistory.shortWindow().mean;
+        netReadings.pmMeanDay = pmHistory.longWindow().mean;
+        netReadings.pmTrend = pmHistory.trend(PM_TREND_THRESHOLD);
+        pmHistory.sparkline(netReadings.pmSparkline, SPARKLINE_COLUMNS, 8);
+    } else {
+        HistoryStats day = temperatureHistory.longWindow();
+        netReadings.temperatureMinDay = day.min;
+        netReadings.temperatureMaxDay = day.max;
+    }
+}
+
+// Log the home station's location and keep its altitude
+static void reportLocation(JsonObject location) {
+    LOG_INFO("Location: Pa Rang Cafe & Art Stay, Chiang Mai, Thailand (UTC+7)");
+    LOG_DEBUG("GPS: %.6f, %.6f (Alt: %.2fm)", location["latitude"].as<float>(),
+              location["longitude"].as<float>(), location["altitude"].as<float>());
+    //ALTITUDE = location["altitude"].as<float>();
+    sprintf(netReadings.altitude, "%.1f", location["altitude"].as<float>());
+    initialFetchDone = true;  // Mark initial fetch as done
+}
+
+// Text for the error codes of a failed request
+static const char* fetchErrorText(int code) {
+    switch (code) {
+        case -1: return "Connection failed";
+        case -2: return "Server not found";
+        case -3: return "Connection timed out";
+        case -4: return "Connection lost";
+        case -5: return "No or invalid response";
+        case -6: return "Invalid response length";
+        case -7: return "Connection refused";
+        case -8: return "Invalid request";
+        case -9: return "Client timeout";
+        case -10: return "Invalid response";
+        case -11: return "Connection reset";
+        default: return "Unknown error";
+    }
+}
+
+// Timestamp of the newest reading seen per sensor, to skip unchanged polls
+char lastPMTimestamp[20];
+char lastTempTimestamp[20];
+
+// Function to fetch sensor data
+FetchResult fetchSensorData(const char* sensorId, bool isPMSensor) {
+  FetchResult result = FETCH_ERROR;
+  if (WiFi.status() == WL_CONNECTED) {
+    FetchRecorder fetch(isPMSensor ? SOURCE_PM : SOURCE_TEMP);
+    char path[48];
+    snprintf(path, sizeof(path), "%s%s/", API_PATH, sensorId);
+    
+    const char* label = isPMSensor ? "PM2.5" : "Temperature";
+    
+    // Set timeout to 10 seconds
+    sensorSession.setTimeout(HTTP_TIMEOUT);
+    sensorSession.setCompression(HTTP_COMPRESSION);
+    
+    // Retry mechanism
+    int retries = 0;
+    int httpResponseCode;
+    
+    while (retries < MAX_RETRIES) {
+      if (retries > 0) {
+        LOG_WARN("Retry #%d of %d...", retries, MAX_RETRIES - 1);
+        delay(RETRY_DELAY);
+        fetch.retries = retries;
+      }
+      
+      httpResponseCode = sensorSession.get(path);
+      
+      if (httpResponseCode > 0) {
+        LOG_INFO("Fetching %s data done%s!", label, sensorSession.reusedConnection() ? " (reused connection)" : "");
+
+        // The reply is an array of readings, newest first. Parse only the
+        // first one from the stream, keeping just the fields we use; the
+        // session drains or closes the rest.
+        ArenaJsonDocument doc(SENSOR_DOC_SIZE);
+        Stream& stream = sensorSession.body();
+        DeserializationError error = DeserializationError::InvalidInput;
+        if (stream.find("[")) {
+          error = deserializeJson(doc, stream, DeserializationOption::Filter(sensorFilter()));
+        }
+        sensorSession.end();
+        
+        if (error) {
+          LOG_ERROR("deserializeJson() failed: %s", error.c_str());
+          fetch.error = httpResponseCode != 200 ? httpResponseCode : FETCH_ERROR_PARSE;
+          return FETCH_ERROR;
+        }
+        fetch.ok = true;
+        result = FETCH_UNCHANGED;
+        
+        // Get the first (most recent) reading
+        JsonObject firstReading = doc.as<JsonObject>();
+        if (!firstReading.isNull()) {
+          JsonArray sensorValues = firstReading["sensordatavalues"];
+          const char* timestamp = firstReading["timestamp"] | "";
+
+          // Nothing to do if the sensor hasn't reported since the last poll
+          char* lastTimestamp = isPMSensor ? lastPMTimestamp : lastTempTimestamp;
+          if (strcmp(timestamp, lastTimestamp) == 0) {
+            LOG_INFO("No new reading since last poll");
+            return FETCH_UNCHANGED;
+          }
+          strncpy(lastTimestamp, timestamp, sizeof(lastPMTimestamp) - 1);
+          
+          // Get location data
+          JsonObject location = firstReading["location"];
+          if (!location.isNull()) {
+              const char* localTime = adjustToLocalTime(timestamp);
+              
+              // Print location info only on initial fetch
+              if (isPMSensor && !initialFetchDone) {
+                  reportLocation(location);
+              }
+              
+              // Only print the values we're interested in
+              for (JsonObject value : sensorValues) {
+                  // Entries without a type or a string value are skipped
+                  const char* value_type = value["value_type"] | "";
+                  const char* value_str = value["value"] | "";
+                  if (value_str[0] == '\0') continue;
+
+                  if (isPMSensor) {
+                      if (strcmp(value_type, "P2") == 0) {
+                          LOG_INFO("%s | PM2.5: %s µg/m³", localTime, value_str);
+                          // was: PM25_actual = value_str;
+                          strncpy(netReadings.pm25, value_str, sizeof(netReadings.pm25) - 1);
+                          pmHistory.record(parseTimestamp(timestamp), toFixedPoint(value_str));
+                          updateHistoryStats(true);
+                          netReadings.restored = false;  // localTime is now a live reading
+                          netReadings.pmVersion++;
+                          netReadings.pmFetchedAt = millis();
+                          result = FETCH_UPDATED;
+                          break;
+                      }
+                  } else {
+                      if (strcmp(value_type, "temperature") == 0) {
+                          LOG_INFO("%s | Temperature: %s °C", localTime, value_str);
+                          // was: TEMP_actual = value_str;
+                          strncpy(netReadings.temperature, value_str, sizeof(netReadings.temperature) - 1);
+                          temperatureHistory.record(parseTimestamp(timestamp), toFixedPoint(value_str));
+                          updateHistoryStats(false);
+                          netReadings.temperatureVersion++;
+                          netReadings.temperatureFetchedAt = millis();
+                          result = FETCH_UPDATED;
+                          break;
+                      }
+                  }
+              }
+          }
+        }
+        break;  // Success, exit retry loop
+      } else {
+        // Print specific error based on code
+        fetch.error = httpResponseCode;
+        LOG_ERROR("Error: %s", fetchErrorText(httpResponseCode));
+      }
+      
+      retries++;
+    }
+  }
+  return result;
+}
+
+#define PM_OUTLIER_MADS 3.0f  // Scaled MADs from the median that still count as agreeing
+#define PM_MAX_FUSED 8         // fuseReadings() limit
+
+static void sortValues(float* values, int count) {
+    for (int i = 1; i < count; i++) {
+        float value = values[i];
+        int j = i;
+        for (; j > 0 && values[j - 1] > value; j--) values[j] = values[j - 1];
+        values[j] = value;
+    }
+}
+
+static float sortedMedian(const float* values, int count) {
+    return count % 2 ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) / 2;
+}
+
+int fuseReadings(float* values, int count, float& result) {
+    if (count == 0) return 0;
+    if (count > PM_MAX_FUSED) count = PM_MAX_FUSED;
+    sortValues(values, count);
+    float median = sortedMedian(values, count);
+
+    // Median absolute deviation, scaled to match a standard deviation
+    float deviations[PM_MAX_FUSED];
+    for (int i = 0; i < count; i++) deviations[i] = fabsf(values[i] - median);
+    sortValues(deviations, count);
+    float limit = PM_OUTLIER_MADS * 1.4826f * sortedMedian(deviations, count);
+    if (limit < PM_OUTLIER_MIN) limit = PM_OUTLIER_MIN;
+
+    // Values stay sorted, so the ones kept are a contiguous run
+    int first = 0;
+    while (first < count && median - values[first] > limit) first++;
+    int last = count;
+    while (last > first && values[last - 1] - median > limit) last--;
+    result = sortedMedian(values + first, last - first);
+    return last - first;
+}
+
+// Newest PM2.5 reading of one station
+struct StationReading {
+    int status;           // HTTP status or HTTPC_ERROR_*, 0 before the request
+    bool valid;           // Reply parsed and has a P2 value
+    char timestamp[20];
+    uint32_t time;        // parseTimestamp(timestamp)
+    float value;
+    uint32_t sensorId;    // Area feed only
+    float distance;       // km from the home coordinates, area feed only
+    float altitude;       // Area feed only
+};
+
+// Parse the reply a station session is holding; the home station also
+// reports its location on the first fetch
+static bool readStation(int index, StationReading& station, FetchRecorder& fetch) {
+    ArenaJsonDocument doc(SENSOR_DOC_SIZE);
+    HttpSession& session = stationSessions[index];
+    Stream& stream = session.body();
+    DeserializationError error = DeserializationError::InvalidInput;
+    if (station.status == 200 && stream.find("[")) {
+        error = deserializeJson(doc, stream, DeserializationOption::Filter(sensorFilter()));
+    }
+    session.end();
+    if (error) {
+        LOG_ERROR("Station %s: %s", pmStations[index],
+                  station.status == 200 ? error.c_str() : "unexpected HTTP status");
+        fetch.error = station.status != 200 ? station.status : FETCH_ERROR_PARSE;
+        return false;
+    }
+
+    JsonObject reading = doc.as<JsonObject>();
+    const char* timestamp = reading["timestamp"] | "";
+    for (JsonObject value : reading["sensordatavalues"].as<JsonArray>()) {
+        const char* type = value["value_type"] | "";
+        if (strcmp(type, "P2") == 0) {
+            strncpy(station.timestamp, timestamp, sizeof(station.timestamp) - 1);
+            station.time = parseTimestamp(timestamp);
+            station.value = atof(value["value"] | "0");
+            station.valid = true;
+            break;
+        }
+    }
+    if (index == 0 && !initialFetchDone && !reading["location"].isNull()) {
+        reportLocation(reading["location"]);
+    }
+    return true;
+}
+
+// Fuse the stations' values and store them as the PM2.5 reading
+static FetchResult storeFusedPM(const StationReading* stations, int count) {
+    // Only stations close to the newest reading; one that stopped
+    // reporting hours ago would otherwise still be counted
+    const StationReading* newest = nullptr;
+    for (int i = 0; i < count; i++) {
+        if (stations[i].valid && (!newest || stations[i].time > newest->time)) newest = &stations[i];
+    }
+    if (!newest) return FETCH_UNCHANGED;
+    float values[PM_MAX_FUSED];
+    int current = 0;
+    for (int i = 0; i < count; i++) {
+        if (stations[i].valid && newest->time - stations[i].time <= PM_STATION_MAX_AGE) {
+            values[current++] = stations[i].value;
+        }
+    }
+
+    float fused;
+    int used = fuseReadings(values, current, fused);
+    char pm25[sizeof(netReadings.pm25)];
+    snprintf(pm25, sizeof(pm25), "%.2f", fused);
+
+    // Nothing to do if no station has reported since the last poll
+    if (strcmp(newest->timestamp, lastPMTimestamp) == 0 && strcmp(pm25, netReadings.pm25) == 0 &&
+        used == netReadings.pmStations) {
+        LOG_INFO("No new reading since last poll");
+        return FETCH_UNCHANGED;
+    }
+    memcpy(lastPMTimestamp, newest->timestamp, sizeof(lastPMTimestamp));
+
+    const char* localTime = adjustToLocalTime(newest->timestamp);
+    LOG_INFO("%s | PM2.5: %s µg/m³ (%d of %d stations)", localTime, pm25, used, count);
+
+    memcpy(netReadings.pm25, pm25, sizeof(netReadings.pm25));
+    netReadings.pmStations = used;
+    pmHistory.record(newest->time, toFixedPoint(pm25));
+    updateHistoryStats(true);
+    netReadings.restored = false;  // localTime is now a live reading
+    netReadings.pmVersion++;
+    netReadings.pmFetchedAt = millis();
+    return FETCH_UPDATED;
+}
+
+FetchResult fetchPMData() {
+    if (WiFi.status() != WL_CONNECTED) return FETCH_ERROR;
+    LOG_INFO("Fetching PM2.5 data from %d station(s)", PM_STATION_COUNT);
+    FetchRecorder fetch(SOURCE_PM);
+
+    static char paths[PM_STATION_COUNT][48];  // Must outlive receive()
+    StationReading stations[PM_STATION_COUNT] = {};
+    int answered = 0;
+
+    // Stations that failed are asked again, but only while none has answered
+    for (int attempt = 0; attempt < MAX_RETRIES && answered == 0; attempt++) {
+        if (attempt > 0) {
+            LOG_WARN("Retry #%d of %d...", attempt, MAX_RETRIES - 1);
+            delay(RETRY_DELAY);
+            fetch.retries = attempt;
+        }
+
+        // Put every request on the wire before reading any reply, so the
+        // stations are served in parallel and the round costs about one
+        // request latency instead of one per station
+        for (int i = 0; i < PM_STATION_COUNT; i++) {
+            snprintf(paths[i], sizeof(paths[i]), "%s%s/", API_PATH, pmStations[i]);
+            stationSessions[i].setTimeout(HTTP_TIMEOUT);
+            stationSessions[i].setCompression(HTTP_COMPRESSION);
+            stations[i].status = stationSessions[i].send(paths[i]);
+        }
+        for (int i = 0; i < PM_STATION_COUNT; i++) {
+            StationReading& station = stations[i];
+            if (station.status == 0) station.status = stationSessions[i].receive();
+            if (station.status < 0) {
+                LOG_ERROR("Station %s: error %d", pmStations[i], station.status);
+                fetch.error = station.status;
+                continue;
+            }
+            if (readStation(i, station, fetch)) answered++;
+        }
+    }
+    if (answered == 0) return FETCH_ERROR;
+    fetch.ok = true;
+
+    return storeFusedPM(stations, PM_STATION_COUNT);
+}
+
+// Fields kept from each record of the area feed
+const JsonDocument& areaFilter() {
+    static StaticJsonDocument<256> filter;
+    if (filter.isNull()) {
+        filter["timestamp"] = true;
+        filter["sensor"]["id"] = true;
+        JsonObject location = filter.createNestedObject("location");
+        location["latitude"] = true;
+        location["longitude"] = true;
+        location["altitude"] = true;
+        filter["sensordatavalues"][0]["value_type"] = true;
+        filter["sensordatavalues"][0]["value"] = true;
+    }
+    return filter;
+}
+
+// Flat-earth distance in km, plenty for a radius of a few km
+static float distanceKm(float latitude, float longitude) {
+    float dy = (latitude - PM_AREA_LATITUDE) * 110.57f;
+    float dx = (longitude - PM_AREA_LONGITUDE) * 111.32f * cosf(PM_AREA_LATITUDE * (float)M_PI / 180);
+    return sqrtf(dx * dx + dy * dy);
+}
+
+// Keep a record if it is a PM sensor in range: the newest reading per
+// sensor, and of the sensors only the nearest PM_MAX_FUSED
+static void addAreaRecord(JsonObject record, StationReading* stations, int& count) {
+    JsonObject location = record["location"];
+    float distance = distanceKm(location["latitude"].as<float>(), location["longitude"].as<float>());
+    if (distance > PM_AREA_RADIUS) return;
+
+    const char* value = nullptr;
+    for (JsonObject entry : record["sensordatavalues"].as<JsonArray>()) {
+        if (strcmp(entry["value_type"] | "", "P2") == 0) {
+            value = entry["value"];
+            break;
+        }
+    }
+    if (!value) return;
+    const char* timestamp = record["timestamp"] | "";
+    uint32_t time = parseTimestamp(timestamp);
+    uint32_t sensorId = record["sensor"]["id"] | 0;
+
+    StationReading* slot = nullptr;
+    for (int i = 0; i < count && !slot; i++) {
+        if (stations[i].sensorId != sensorId) continue;
+        if (time <= stations[i].time) return;  // Already have a newer one
+        slot = &stations[i];
+    }
+    if (!slot && count < PM_MAX_FUSED) slot = &stations[count++];
+    if (!slot) {
+        slot = &stations[0];
+        for (int i = 1; i < count; i++) {
+            if (stations[i].distance > slot->distance) slot = &stations[i];
+        }
+        if (distance >= slot->distance) return;
+    }
+
+    slot->status = 200;
+    slot->valid = true;
+    strncpy(slot->timestamp, timestamp, sizeof(slot->timestamp) - 1);
+    slot->time = time;
+    slot->value = atof(value);
+    slot->sensorId = sensorId;
+    slot->distance = distance;
+    slot->altitude = location["altitude"].as<float>();
+}
+
+FetchResult fetchAreaData() {
+    if (WiFi.status() != WL_CONNECTED) return FETCH_ERROR;
+    FetchRecorder fetch(SOURCE_PM);
+    char path[80];
+    snprintf(path, sizeof(path), "/airrohr/v1/filter/area=%.4f,%.4f,%.1f",
+             PM_AREA_LATITUDE, PM_AREA_LONGITUDE, PM_AREA_RADIUS);
+    LOG_INFO("Fetching PM2.5 area feed %s", path);
+
+    sensorSession.setTimeout(HTTP_TIMEOUT);
+    sensorSession.setCompression(HTTP_COMPRESSION);
+    int statusCode = 0;
+    for (int attempt = 0; attempt < MAX_RETRIES; attempt++) {
+        if (attempt > 0) {
+            LOG_WARN("Retry #%d of %d...", attempt, MAX_RETRIES - 1);
+            delay(RETRY_DELAY);
+            fetch.retries = attempt;
+        }
+        statusCode = sensorSession.get(path);
+        if (statusCode > 0) break;
+        LOG_ERROR("Error: %d", statusCode);
+        fetch.error = statusCode;
+    }
+    if (statusCode <= 0) return FETCH_ERROR;
+    if (statusCode != 200) {
+        LOG_ERROR("Unexpected HTTP status: %d", statusCode);
+        sensorSession.close();
+        fetch.error = statusCode;
+        return FETCH_ERROR;
+    }
+
+    // The feed runs to hundreds of KB: read it one array element at a time
+    // into the same small document, keeping only the nearby PM sensors
+    ArenaJsonDocument doc(SENSOR_DOC_SIZE);
+    StationReading stations[PM_MAX_FUSED] = {};
+    int count = 0;
+    int records = 0;
+    Stream& stream = sensorSession.body();
+    DeserializationError error = DeserializationError::InvalidInput;
+    if (stream.find("[")) {
+        do {
+            error = deserializeJson(doc, stream, DeserializationOption::Filter(areaFilter()));
+            if (error) break;
+            records++;
+            addAreaRecord(doc.as<JsonObject>(), stations, count);
+        } while (stream.findUntil(",", "]"));
+    }
+    sensorSession.end();
+
+    // Records are independent, so a feed cut short still gives usable values
+    if (error && records == 0) {
+        LOG_ERROR("Area feed parsing failed: %s", error.c_str());
+        fetch.error = FETCH_ERROR_PARSE;
+        return FETCH_ERROR;
+    }
+    fetch.ok = true;
+    LOG_INFO("Area feed: %d records, %d PM sensors within %.1f km", records, count, PM_AREA_RADIUS);
+    if (count == 0) return FETCH_UNCHANGED;
+
+    if (!initialFetchDone) {
+        const StationReading* nearest = &stations[0];
+        for (int i = 1; i < count; i++) {
+            if (stations[i].distance < nearest->distance) nearest = &stations[i];
+        }
+        sprintf(netReadings.altitude, "%.1f", nearest->altitude);
+        initialFetchDone = true;
+    }
+    return storeFusedPM(stations, count);
+}
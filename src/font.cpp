@@ -0,0 +1,341 @@
+#include "font.h"
+
+#define GLYPH_MARK 0x8000        // Offset flag: combining mark, drawn over the previous glyph
+#define GLYPH_BLANK_WIDTH 5      // Advance of a character without a glyph
+#define GLYPH_MAX_WIDTH 5
+
+// Codepoints first..last are glyphs glyph.. in order
+struct GlyphRange {
+    uint16_t first;
+    uint16_t last;
+    uint16_t glyph;
+};
+
+// Glyph atlas: the columns of every glyph back to back, blank columns
+// trimmed (digits keep full width so numbers line up). Bit y is row y.
+// Latin uses rows 0-6; Thai consonants sit on rows 2-6 with tall strokes
+// and marks above in rows 0-1 and marks below in row 7.
+const uint8_t PROGMEM GLYPH_COLUMNS[] = {
+    0x00, 0x00, 0x00,                   // space
+    0x5F,                               // ! 33
+    0x07, 0x00, 0x07,                   // " 34
+    0x14, 0x7F, 0x14, 0x7F, 0x14,       // # 35
+    0x24, 0x2A, 0x7F, 0x2A, 0x12,       // $ 36
+    0x23, 0x13, 0x08, 0x64, 0x62,       // % 37
+    0x36, 0x49, 0x55, 0x22, 0x50,       // & 38
+    0x05, 0x03,                         // ' 39
+    0x1C, 0x22, 0x41,                   // ( 40
+    0x41, 0x22, 0x1C,                   // ) 41
+    0x14, 0x08, 0x3E, 0x08, 0x14,       // * 42
+    0x08, 0x08, 0x3E, 0x08, 0x08,       // + 43
+    0x50, 0x30,                         // , 44
+    0x08, 0x08, 0x08, 0x08, 0x08,       // - 45
+    0x60, 0x60,                         // . 46
+    0x20, 0x10, 0x08, 0x04, 0x02,       // / 47
+    0x3E, 0x51, 0x49, 0x45, 0x3E,       // 0 48
+    0x00, 0x42, 0x7F, 0x40, 0x00,       // 1 49
+    0x42, 0x61, 0x51, 0x49, 0x46,       // 2 50
+    0x21, 0x41, 0x45, 0x4B, 0x31,       // 3 51
+    0x18, 0x14, 0x12, 0x7F, 0x10,       // 4 52
+    0x27, 0x45, 0x45, 0x45, 0x39,       // 5 53
+    0x3C, 0x4A, 0x49, 0x49, 0x30,       // 6 54
+    0x01, 0x71, 0x09, 0x05, 0x03,       // 7 55
+    0x36, 0x49, 0x49, 0x49, 0x36,       // 8 56
+    0x06, 0x49, 0x49, 0x29, 0x1E,       // 9 57
+    0x36, 0x36,                         // : 58
+    0x56, 0x36,                         // ; 59
+    0x08, 0x14, 0x22, 0x41,             // < 60
+    0x14, 0x14, 0x14, 0x14, 0x14,       // = 61
+    0x41, 0x22, 0x14, 0x08,             // > 62
+    0x02, 0x01, 0x51, 0x09, 0x06,       // ? 63
+    0x32, 0x49, 0x79, 0x41, 0x3E,       // @ 64
+    0x7E, 0x11, 0x11, 0x11, 0x7E,       // A 65
+    0x7F, 0x49, 0x49, 0x49, 0x36,       // B 66
+    0x3E, 0x41, 0x41, 0x41, 0x22,       // C 67
+    0x7F, 0x41, 0x41, 0x22, 0x1C,       // D 68
+    0x7F, 0x49, 0x49, 0x49, 0x41,       // E 69
+    0x7F, 0x09, 0x09, 0x09, 0x01,       // F 70
+    0x3E, 0x41, 0x49, 0x49, 0x7A,       // G 71
+    0x7F, 0x08, 0x08, 0x08, 0x7F,       // H 72
+    0x41, 0x7F, 0x41,                   // I 73
+    0x20, 0x40, 0x41, 0x3F, 0x01,       // J 74
+    0x7F, 0x08, 0x14, 0x22, 0x41,       // K 75
+    0x7F, 0x40, 0x40, 0x40, 0x40,       // L 76
+    0x7F, 0x02, 0x0C, 0x02, 0x7F,       // M 77
+    0x7F, 0x04, 0x08, 0x10, 0x7F,       // N 78
+    0x3E, 0x41, 0x41, 0x41, 0x3E,       // O 79
+    0x7F, 0x09, 0x09, 0x09, 0x06,       // P 80
+    0x3E, 0x41, 0x51, 0x21, 0x5E,       // Q 81
+    0x7F, 0x09, 0x19, 0x29, 0x46,       // R 82
+    0x46, 0x49, 0x49, 0x49, 0x31,       // S 83
+    0x01, 0x01, 0x7F, 0x01, 0x01,       // T 84
+    0x3F, 0x40, 0x40, 0x40, 0x3F,       // U 85
+    0x1F, 0x20, 0x40, 0x20, 0x1F,       // V 86
+    0x3F, 0x40, 0x38, 0x40, 0x3F,       // W 87
+    0x63, 0x14, 0x08, 0x14, 0x63,       // X 88
+    0x07, 0x08, 0x70, 0x08, 0x07,       // Y 89
+    0x61, 0x51, 0x49, 0x45, 0x43,       // Z 90
+    0x7F, 0x41, 0x41,                   // [ 91
+    0x02, 0x04, 0x08, 0x10, 0x20,       // \ 92
+    0x41, 0x41, 0x7F,                   // ] 93
+    0x04, 0x02, 0x01, 0x02, 0x04,       // ^ 94
+    0x40, 0x40, 0x40, 0x40, 0x40,       // _ 95
+    0x01, 0x02, 0x04,                   // ` 96
+    0x20, 0x54, 0x54, 0x54, 0x78,       // a 97
+    0x7F, 0x48, 0x44, 0x44, 0x38,       // b 98
+    0x38, 0x44, 0x44, 0x44, 0x20,       // c 99
+    0x38, 0x44, 0x44, 0x48, 0x7F,       // d 100
+    0x38, 0x54, 0x54, 0x54, 0x18,       // e 101
+    0x08, 0x7E, 0x09, 0x01, 0x02,       // f 102
+    0x0C, 0x52, 0x52, 0x52, 0x3E,       // g 103
+    0x7F, 0x08, 0x04, 0x04, 0x78,       // h 104
+    0x44, 0x7D, 0x40,                   // i 105
+    0x20, 0x40, 0x44, 0x3D,             // j 106
+    0x7F, 0x10, 0x28, 0x44,             // k 107
+    0x41, 0x7F, 0x40,                   // l 108
+    0x7C, 0x04, 0x18, 0x04, 0x78,       // m 109
+    0x7C, 0x08, 0x04, 0x04, 0x78,       // n 110
+    0x38, 0x44, 0x44, 0x44, 0x38,       // o 111
+    0x7C, 0x14, 0x14, 0x14, 0x08,       // p 112
+    0x08, 0x14, 0x14, 0x18, 0x7C,       // q 113
+    0x7C, 0x08, 0x04, 0x04, 0x08,       // r 114
+    0x48, 0x54, 0x54, 0x54, 0x20,       // s 115
+    0x04, 0x3F, 0x44, 0x40, 0x20,       // t 116
+    0x3C, 0x40, 0x40, 0x20, 0x7C,       // u 117
+    0x1C, 0x20, 0x40, 0x20, 0x1C,       // v 118
+    0x3C, 0x40, 0x30, 0x40, 0x3C,       // w 119
+    0x44, 0x28, 0x10, 0x28, 0x44,       // x 120
+    0x0C, 0x50, 0x50, 0x50, 0x3C,       // y 121
+    0x44, 0x64, 0x54, 0x4C, 0x44,       // z 122
+    0x08, 0x36, 0x41,                   // { 123
+    0x7F,                               // | 124
+    0x41, 0x36, 0x08,                   // } 125
+    0x08, 0x04, 0x08, 0x10, 0x08,       // ~ 126
+    0x06, 0x09, 0x09, 0x06,             // U+00B0 degree sign
+    0x09, 0x0D, 0x0A,                   // U+00B2 superscript two
+    0x11, 0x15, 0x0A,                   // U+00B3 superscript three
+    0x7C, 0x20, 0x20, 0x10, 0x3C,       // U+00B5 micro sign
+    0x78, 0x04, 0x04, 0x7C,             // U+0E01 ko kai
+    0x04, 0x7C, 0x40, 0x7C,             // U+0E02 kho khai
+    0x04, 0x7C, 0x48, 0x7C,             // U+0E03 kho khuat
+    0x78, 0x34, 0x04, 0x78,             // U+0E04 kho khwai
+    0x7C, 0x30, 0x0C, 0x78,             // U+0E05 kho khon
+    0x0C, 0x78, 0x40, 0x64, 0x7C,       // U+0E06 kho rakhang
+    0x30, 0x60, 0x40, 0x3C,             // U+0E07 ngo ngu
+    0x08, 0x64, 0x44, 0x38,             // U+0E08 cho chan
+    0x68, 0x64, 0x44, 0x78,             // U+0E09 cho ching
+    0x0C, 0x78, 0x40, 0x7C, 0x04,       // U+0E0A cho chang
+    0x0C, 0x78, 0x44, 0x7C, 0x04,       // U+0E0B so so
+    0x0C, 0x78, 0x20, 0x30, 0x7C,       // U+0E0C cho choe
+    0x0C, 0x78, 0xC0, 0x60, 0xFC,       // U+0E0D yo ying
+    0xF8, 0x14, 0x84, 0x78,             // U+0E0E do chada
+    0xF8, 0x14, 0x84, 0xF8,             // U+0E0F to patak
+    0xA8, 0xC4, 0xD4, 0x28,             // U+0E10 tho than
+    0x18, 0x74, 0x08, 0x04, 0x78,       // U+0E11 tho nangmontho
+    0x0C, 0x78, 0x40, 0x20, 0x7C,       // U+0E12 tho phuthao
+    0x38, 0x74, 0x04, 0x78, 0x60,       // U+0E13 no nen
+    0x78, 0x64, 0x04, 0x78,             // U+0E14 do dek
+    0x7C, 0x60, 0x0C, 0x78,             // U+0E15 to tao
+    0x78, 0x14, 0x04, 0x78,             // U+0E16 tho thung
+    0x7C, 0x08, 0x10, 0x7C,             // U+0E17 tho thahan
+    0x0C, 0x50, 0x54, 0x24,             // U+0E18 tho thong
+    0x0C, 0x78, 0x00, 0x7C, 0x40,       // U+0E19 no nu
+    0x0C, 0x78, 0x40, 0x7C,             // U+0E1A bo baimai
+    0x0C, 0x78, 0x40, 0x7F,             // U+0E1B po pla
+    0x0C, 0x78, 0x40, 0x20, 0x5C,       // U+0E1C pho phung
+    0x0C, 0x78, 0x40, 0x20, 0x5F,       // U+0E1D fo fa
+    0x0C, 0x78, 0x40, 0x30, 0x5C,       // U+0E1E pho phan
+    0x0C, 0x78, 0x40, 0x30, 0x5F,       // U+0E1F fo fan
+    0x18, 0x74, 0x04, 0x78,             // U+0E20 pho samphao
+    0x7C, 0x30, 0x40, 0x7C,             // U+0E21 mo ma
+    0x6C, 0x58, 0x40, 0x7C,             // U+0E22 yo yak
+    0x0C, 0x54, 0x54, 0x24,             // U+0E23 ro rua
+    0x18, 0x74, 0x04, 0xF8,             // U+0E24 ru
+    0x68, 0x74, 0x04, 0x78,             // U+0E25 lo ling
+    0x68, 0x74, 0x04, 0xF8,             // U+0E26 lu
+    0x64, 0x44, 0x38,                   // U+0E27 wo waen
+    0x78, 0x34, 0x46, 0x79,             // U+0E28 so sala
+    0x0C, 0x78, 0x50, 0x7C,             // U+0E29 so rusi
+    0x68, 0x74, 0x06, 0x79,             // U+0E2A so sua
+    0x7C, 0x20, 0x10, 0x7C,             // U+0E2B ho hip
+    0x7C, 0x08, 0x10, 0x22, 0x7D,       // U+0E2C lo chula
+    0x38, 0x74, 0x44, 0x38,             // U+0E2D o ang
+    0x39, 0x76, 0x47, 0x38,             // U+0E2E ho nokhuk
+    0x0C, 0x18, 0x00, 0x7C,             // U+0E2F paiyannoi
+    0x6C, 0x48, 0x24,                   // U+0E30 sara a
+    0x01, 0x02, 0x02, 0x01,             // U+0E31 mai han-akat
+    0x0C, 0x04, 0x78,                   // U+0E32 sara aa
+    0x0D, 0x04, 0x78,                   // U+0E33 sara am
+    0x02, 0x03, 0x03, 0x02,             // U+0E34 sara i
+    0x02, 0x02, 0x02, 0x03,             // U+0E35 sara ii
+    0x02, 0x02, 0x03, 0x03,             // U+0E36 sara ue
+    0x02, 0x03, 0x02, 0x03,             // U+0E37 sara uee
+    0x80, 0x80,                         // U+0E38 sara u
+    0x80, 0x80, 0x80,                   // U+0E39 sara uu
+    0x80,                               // U+0E3A phinthu
+    0x7F, 0x49, 0xFF, 0x49, 0x36,       // U+0E3F thai currency symbol baht
+    0x7C, 0x60,                         // U+0E40 sara e
+    0x7C, 0x60, 0x7C, 0x60,             // U+0E41 sara ae
+    0x7F, 0x61,                         // U+0E42 sara o
+    0x7E, 0x61, 0x02,                   // U+0E43 sara ai maimuan
+    0x7D, 0x62, 0x03,                   // U+0E44 sara ai maimalai
+    0x04, 0x04, 0xF8,                   // U+0E45 lakkhangyao
+    0x0C, 0x08, 0x44, 0x3C,             // U+0E46 maiyamok
+    0x03, 0x02, 0x03,                   // U+0E47 maitaikhu
+    0x03,                               // U+0E48 mai ek
+    0x03, 0x02, 0x01,                   // U+0E49 mai tho
+    0x03, 0x01, 0x03,                   // U+0E4A mai tri
+    0x02, 0x03, 0x02,                   // U+0E4B mai chattawa
+    0x03, 0x01,                         // U+0E4C thanthakhat
+    0x03, 0x03,                         // U+0E4D nikhahit
+    0x03, 0x02,                         // U+0E4E yamakkan
+    0x38, 0x44, 0x54, 0x38,             // U+0E4F fongman
+    0x38, 0x44, 0x44, 0x38,             // U+0E50 digit zero
+    0x18, 0x54, 0x44, 0x38,             // U+0E51 digit one
+    0x3C, 0x48, 0x40, 0x3C,             // U+0E52 digit two
+    0x78, 0x14, 0x08, 0x14, 0x78,       // U+0E53 digit three
+    0x1C, 0x10, 0x48, 0x38,             // U+0E54 digit four
+    0x1C, 0x10, 0x4C, 0x38,             // U+0E55 digit five
+    0x24, 0x48, 0x50, 0x20,             // U+0E56 digit six
+    0x3C, 0x48, 0x20, 0x10, 0x7C,       // U+0E57 digit seven
+    0x20, 0x50, 0x48, 0x34,             // U+0E58 digit eight
+    0x38, 0x44, 0x54, 0x34,             // U+0E59 digit nine
+    0x08, 0x1C, 0x2A, 0x08, 0x08,       // U+2190 leftwards arrow
+    0x04, 0x02, 0x7F, 0x02, 0x04,       // U+2191 upwards arrow
+    0x08, 0x08, 0x2A, 0x1C, 0x08,       // U+2192 rightwards arrow
+    0x10, 0x20, 0x7F, 0x20, 0x10,       // U+2193 downwards arrow
+};
+
+const uint16_t PROGMEM GLYPH_OFFSETS[] = {
+    0, 3, 4, 7, 12, 17, 22, 27, 29, 32,
+    35, 40, 45, 47, 52, 54, 59, 64, 69, 74,
+    79, 84, 89, 94, 99, 104, 109, 111, 113, 117,
+    122, 126, 131, 136, 141, 146, 151, 156, 161, 166,
+    171, 176, 179, 184, 189, 194, 199, 204, 209, 214,
+    219, 224, 229, 234, 239, 244, 249, 254, 259, 264,
+    267, 272, 275, 280, 285, 288, 293, 298, 303, 308,
+    313, 318, 323, 328, 331, 335, 339, 342, 347, 352,
+    357, 362, 367, 372, 377, 382, 387, 392, 397, 402,
+    407, 412, 415, 416, 419, 424, 428, 431, 434, 439,
+    443, 447, 451, 455, 459, 464, 468, 472, 476, 481,
+    486, 491, 496, 500, 504, 508, 513, 518, 523, 527,
+    531, 535, 539, 543, 548, 552, 556, 561, 566, 571,
+    576, 580, 584, 588, 592, 596, 600, 604, 607, 611,
+    615, 619, 623, 628, 632, 636, 640, 0x8283, 647, 650,
+    0x828D, 0x8291, 0x8295, 0x8299, 0x829D, 0x829F, 0x82A2, 675, 680, 682,
+    686, 688, 691, 694, 697, 0x82BD, 0x82C0, 0x82C1, 0x82C4, 0x82C7,
+    0x82CA, 0x82CC, 0x82CE, 720, 724, 728, 732, 736, 741, 745,
+    749, 753, 758, 762, 766, 771, 776, 781, 786,
+};
+
+const GlyphRange PROGMEM GLYPH_RANGES[] = {
+    {0x0020, 0x007E, 0},
+    {0x00B0, 0x00B0, 95},
+    {0x00B2, 0x00B3, 96},
+    {0x00B5, 0x00B5, 98},
+    {0x0E01, 0x0E3A, 99},
+    {0x0E3F, 0x0E59, 157},
+    {0x2190, 0x2193, 184},
+};
+
+// Glyph index for a codepoint, or -1. ASCII maps directly; the rest is a
+// binary search over the few ranges.
+static int findGlyph(uint32_t codepoint) {
+    if (codepoint >= 0x20 && codepoint <= 0x7E) return codepoint - 0x20;
+    int low = 1;
+    int high = sizeof(GLYPH_RANGES) / sizeof(GLYPH_RANGES[0]) - 1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        uint16_t first = pgm_read_word(&GLYPH_RANGES[mid].first);
+        if (codepoint < first) {
+            high = mid - 1;
+        } else if (codepoint > pgm_read_word(&GLYPH_RANGES[mid].last)) {
+            low = mid + 1;
+        } else {
+            return pgm_read_word(&GLYPH_RANGES[mid].glyph) + (codepoint - first);
+        }
+    }
+    return -1;
+}
+
+// Decode one UTF-8 sequence and advance past it. Malformed input gives
+// U+FFFD and skips a single byte.
+static uint32_t nextCodepoint(const char*& p) {
+    uint8_t lead = *p++;
+    if (lead < 0x80) return lead;
+    int extra = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+    if (extra == 0 || lead >= 0xF8) return 0xFFFD;
+    uint32_t codepoint = lead & (0x3F >> extra);
+    for (int i = 0; i < extra; i++) {
+        uint8_t next = p[i];
+        if ((next & 0xC0) != 0x80) return 0xFFFD;
+        codepoint = (codepoint << 6) | (next & 0x3F);
+    }
+    p += extra;
+    return codepoint;
+}
+
+int rasterizeText(const char* text, uint8_t* columns, int maxColumns) {
+    int count = 0;
+    int baseStart = -1;          // Ink of the last spacing glyph, for marks
+    int baseEnd = -1;
+    for (const char* p = text; *p;) {
+        uint8_t c = *p;
+        int glyph;
+        if (c < 0x80) {
+            // Plain ASCII needs no decoding or search
+            glyph = c >= 0x20 && c <= 0x7E ? c - 0x20 : -1;
+            p++;
+        } else {
+            glyph = findGlyph(nextCodepoint(p));
+        }
+
+        if (glyph < 0) {
+            if (count + GLYPH_BLANK_WIDTH + 1 > maxColumns) break;
+            memset(columns + count, 0, GLYPH_BLANK_WIDTH + 1);
+            count += GLYPH_BLANK_WIDTH + 1;
+            baseStart = baseEnd = -1;
+            continue;
+        }
+
+        uint16_t start = pgm_read_word(&GLYPH_OFFSETS[glyph]);
+        uint16_t end = pgm_read_word(&GLYPH_OFFSETS[glyph + 1]) & ~GLYPH_MARK;
+        const uint8_t* bits = GLYPH_COLUMNS + (start & ~GLYPH_MARK);
+        int width = end - (start & ~GLYPH_MARK);
+
+        if ((start & GLYPH_MARK) && baseStart >= 0) {
+            // Right-aligned over the base. A mark that is wider than the base
+            // or would hit ink already there (vowel + tone mark) goes right
+            // after it instead.
+            int x = baseEnd - width;
+            bool fits = x >= baseStart;
+            for (int i = 0; fits && i < width; i++) {
+                if (columns[x + i] & pgm_read_byte(&bits[i])) fits = false;
+            }
+            if (fits) {
+                for (int i = 0; i < width; i++) columns[x + i] |= pgm_read_byte(&bits[i]);
+                continue;
+            }
+            if (baseEnd + width + 1 > maxColumns) break;
+            for (int i = 0; i < width; i++) columns[baseEnd + i] = pgm_read_byte(&bits[i]);
+            baseEnd += width;
+            columns[baseEnd] = 0;
+            count = baseEnd + 1;
+            continue;
+        }
+
+        if (count + width + 1 > maxColumns) break;
+        baseStart = count;
+        if (count + GLYPH_MAX_WIDTH <= maxColumns) {
+            // A fixed-size copy compiles to a couple of moves; the spacing
+            // column and later glyphs overwrite what is past this one
+            memcpy_P(columns + count, bits, GLYPH_MAX_WIDTH);
+            count += width;
+        } else {
+            for (int i = 0; i < width; i++) columns[count++] = pgm_read_byte(&bits[i]);
+        }
+        baseEnd = count;
+        columns[count++] = 0;
+    }
+    return count;
+}
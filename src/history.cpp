@@ -0,0 +1,156 @@
+#include "history.h"
+
+template <uint8_t LENGTH>
+void RollingWindow<LENGTH>::expire(const int16_t* ring, uint8_t position) {
+    uint8_t old = outgoing(position);
+    if (ring[old] != HISTORY_NO_DATA) {
+        total -= ring[old];
+        samples--;
+    }
+    // The oldest entry of a deque is at its front
+    if (minSize && minQueue[minFront] == old) {
+        minFront = (minFront + 1) % LENGTH;
+        minSize--;
+    }
+    if (maxSize && maxQueue[maxFront] == old) {
+        maxFront = (maxFront + 1) % LENGTH;
+        maxSize--;
+    }
+}
+
+template <uint8_t LENGTH>
+void RollingWindow<LENGTH>::add(const int16_t* ring, uint8_t position) {
+    int16_t value = ring[position];
+    if (value == HISTORY_NO_DATA) return;
+    total += value;
+    samples++;
+
+    // Entries the new value beats can never be the min (or max) again
+    while (minSize && ring[minQueue[(minFront + minSize - 1) % LENGTH]] >= value) minSize--;
+    minQueue[(minFront + minSize) % LENGTH] = position;
+    minSize++;
+
+    while (maxSize && ring[maxQueue[(maxFront + maxSize - 1) % LENGTH]] <= value) maxSize--;
+    maxQueue[(maxFront + maxSize) % LENGTH] = position;
+    maxSize++;
+}
+
+// The two window lengths History uses
+template class RollingWindow<HISTORY_SHORT_SLOTS>;
+template class RollingWindow<HISTORY_SLOTS>;
+
+History::History() {
+    for (int i = 0; i < HISTORY_SLOTS; i++) ring[i] = HISTORY_NO_DATA;
+}
+
+void History::commit(int16_t value) {
+    uint8_t position = (head + 1) % HISTORY_SLOTS;
+    hour.expire(ring, position);
+    day.expire(ring, position);
+    ring[position] = value;
+    head = position;
+    hour.add(ring, position);
+    day.add(ring, position);
+}
+
+void History::record(uint32_t timestamp, int16_t value) {
+    if (value == HISTORY_NO_DATA || timestamp == 0) return;
+    uint32_t slot = timestamp / HISTORY_SLOT_SECONDS;
+    if (openSlot == 0) openSlot = slot;
+    if (slot < openSlot) return;
+
+    if (slot > openSlot) {
+        commit(pendingCount ? (int16_t)(pendingSum / pendingCount) : HISTORY_NO_DATA);
+        // Slots without readings stay empty; after a day offline the ring is simply cleared
+        uint32_t gap = slot - openSlot - 1;
+        if (gap > HISTORY_SLOTS) gap = HISTORY_SLOTS;
+        for (uint32_t i = 0; i < gap; i++) commit(HISTORY_NO_DATA);
+        openSlot = slot;
+        pendingSum = 0;
+        pendingCount = 0;
+    }
+    if (pendingCount < 255) {
+        pendingSum += value;
+        pendingCount++;
+    }
+}
+
+template <uint8_t LENGTH>
+HistoryStats History::window(const RollingWindow<LENGTH>& w) const {
+    int32_t sum = w.sum();
+    int count = w.count();
+    int16_t low = w.min(ring);
+    int16_t high = w.max(ring);
+    if (pendingCount) {
+        int16_t pending = pendingSum / pendingCount;
+        sum += pending;
+        count++;
+        if (low == HISTORY_NO_DATA || pending < low) low = pending;
+        if (high == HISTORY_NO_DATA || pending > high) high = pending;
+    }
+
+    HistoryStats stats;
+    if (count == 0) return stats;
+    stats.mean = (int16_t)((sum + (sum >= 0 ? count / 2 : -count / 2)) / count);
+    stats.min = low;
+    stats.max = high;
+    return stats;
+}
+
+HistoryStats History::shortWindow() const { return window(hour); }
+HistoryStats History::longWindow() const { return window(day); }
+
+int16_t History::latest() const {
+    return pendingCount ? (int16_t)(pendingSum / pendingCount) : ring[head];
+}
+
+int8_t History::trend(int16_t threshold) const {
+    int16_t now = latest();
+    int16_t mean = shortWindow().mean;
+    if (now == HISTORY_NO_DATA || mean == HISTORY_NO_DATA) return 0;
+    if (now - mean > threshold) return 1;
+    if (mean - now > threshold) return -1;
+    return 0;
+}
+
+void History::sparkline(uint8_t* heights, uint8_t columns, uint8_t height) const {
+    if (columns > HISTORY_SPARKLINE_MAX) {
+        memset(heights + HISTORY_SPARKLINE_MAX, 0, columns - HISTORY_SPARKLINE_MAX);
+        columns = HISTORY_SPARKLINE_MAX;
+    }
+    uint8_t slotsPerColumn = HISTORY_SLOTS / columns;
+    int16_t means[HISTORY_SPARKLINE_MAX];
+    int16_t low = INT16_MAX, high = INT16_MIN;
+
+    for (uint8_t c = 0; c < columns; c++) {
+        int32_t sum = 0;
+        int count = 0;
+        for (uint8_t i = 0; i < slotsPerColumn; i++) {
+            int age = (columns - 1 - c) * slotsPerColumn + i;  // Slots before head
+            int16_t value = ring[(head + HISTORY_SLOTS - age) % HISTORY_SLOTS];
+            if (value == HISTORY_NO_DATA) continue;
+            sum += value;
+            count++;
+        }
+        means[c] = count ? (int16_t)(sum / count) : HISTORY_NO_DATA;
+        if (count && means[c] < low) low = means[c];
+        if (count && means[c] > high) high = means[c];
+    }
+
+    for (uint8_t c = 0; c < columns; c++) {
+        if (means[c] == HISTORY_NO_DATA) {
+            heights[c] = 0;
+        } else if (high == low) {
+            heights[c] = (height + 1) / 2;
+        } else {
+            heights[c] = 1 + (int32_t)(means[c] - low) * (height - 1) / (high - low);
+        }
+    }
+}
+
+int16_t toFixedPoint(const char* value) {
+    float scaled = atof(value) * 10.0f;
+    if (scaled >= 32767.0f) return 32767;
+    if (scaled <= -32767.0f) return -32767;
+    return (int16_t)(scaled >= 0 ? scaled + 0.5f : scaled - 0.5f);
+}
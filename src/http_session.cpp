@@ -0,0 +1,249 @@
+#include "http_session.h"
+
+void HttpBodyStream::reset(WiFiClient* c, long contentLength, bool isChunked, unsigned long timeout) {
+    client = c;
+    chunked = isChunked;
+    remaining = chunked ? 0 : contentLength;
+    timeoutMs = timeout;
+    done = !chunked && contentLength == 0;
+}
+
+// Read one byte from the socket, waiting up to the timeout for it
+int HttpBodyStream::readRaw() {
+    unsigned long start = millis();
+    do {
+        int c = client->read();
+        if (c >= 0) return c;
+        if (!client->connected()) return -1;
+        delay(1);
+    } while (millis() - start < timeoutMs);
+    return -1;
+}
+
+// Parse a "<hex size>[;ext]\r\n" chunk header. The zero-size chunk ends the body.
+bool HttpBodyStream::readChunkHeader() {
+    long size = 0;
+    bool digits = false;
+    bool extension = false;
+    for (;;) {
+        int c = readRaw();
+        if (c < 0) return false;
+        if (c == '\n') {
+            if (digits) break;
+            continue;  // CRLF that closed the previous chunk
+        }
+        if (c == ';') extension = true;
+        if (extension || c == '\r') continue;
+        if (isxdigit(c)) {
+            size = size * 16 + (isdigit(c) ? c - '0' : (tolower(c) - 'a' + 10));
+            digits = true;
+        }
+    }
+    if (size == 0) {
+        // Last chunk: skip trailers up to the empty line
+        int previous = '\n';
+        for (;;) {
+            int c = readRaw();
+            if (c < 0 || (c == '\n' && previous == '\n')) break;
+            if (c != '\r') previous = c;
+        }
+        done = true;
+        return false;
+    }
+    remaining = size;
+    return true;
+}
+
+bool HttpBodyStream::ensureData() {
+    if (done || client == nullptr) return false;
+    if (remaining == 0) {
+        if (!chunked) {
+            done = true;
+            return false;
+        }
+        return readChunkHeader();
+    }
+    return true;
+}
+
+int HttpBodyStream::available() {
+    if (!ensureData()) return 0;
+    int avail = client->available();
+    if (remaining > 0 && avail > remaining) avail = remaining;
+    return avail;
+}
+
+int HttpBodyStream::read() {
+    if (!ensureData()) return -1;
+    int c = client->read();
+    if (c >= 0) {
+        if (remaining > 0) remaining--;
+    } else if (remaining < 0 && !client->connected()) {
+        done = true;  // Body delimited by connection close
+    }
+    return c;
+}
+
+int HttpBodyStream::peek() {
+    if (!ensureData()) return -1;
+    return client->peek();
+}
+
+bool HttpSession::connect() {
+    // Resolve through the cache; the address is refreshed after HTTP_DNS_TTL
+    if (!resolved || millis() - resolvedAt >= HTTP_DNS_TTL) {
+        if (!WiFi.hostByName(host, address)) {
+            resolved = false;
+            return false;
+        }
+        resolved = true;
+        resolvedAt = millis();
+    }
+    if (!client.connect(address, port)) {
+        resolved = false;  // Address may have moved, look it up again next time
+        return false;
+    }
+    return true;
+}
+
+bool HttpSession::sendRequest(const char* path) {
+    char request[512];
+    int length = snprintf(request, sizeof(request),
+                          "GET %s HTTP/1.1\r\n"
+                          "Host: %s\r\n"
+                          "%s"
+                          "Connection: keep-alive\r\n"
+                          "\r\n",
+                          path, host, compression ? "Accept-Encoding: gzip, deflate\r\n" : "");
+    if (length <= 0 || length >= (int)sizeof(request)) return false;
+    return client.write((const uint8_t*)request, length) == (size_t)length;
+}
+
+// Read one header line without the trailing CRLF; overlong lines are truncated
+bool HttpSession::readLine(char* buffer, size_t size) {
+    size_t length = 0;
+    unsigned long start = millis();
+    for (;;) {
+        int c = client.read();
+        if (c < 0) {
+            if (!client.connected() || millis() - start >= timeoutMs) return false;
+            delay(1);
+            continue;
+        }
+        if (c == '\n') break;
+        if (c != '\r' && length < size - 1) buffer[length++] = c;
+    }
+    buffer[length] = '\0';
+    return true;
+}
+
+// Case-insensitive search for a token in a header value
+static bool headerHasToken(const char* value, const char* token) {
+    size_t length = strlen(token);
+    for (; *value; value++) {
+        if (strncasecmp(value, token, length) == 0) return true;
+    }
+    return false;
+}
+
+int HttpSession::readResponseHead() {
+    char line[128];
+    if (!readLine(line, sizeof(line))) return HTTPC_ERROR_READ_TIMEOUT;
+
+    int statusCode = 0;
+    if (sscanf(line, "HTTP/%*d.%*d %d", &statusCode) != 1) return HTTPC_ERROR_NO_HTTP_SERVER;
+
+    bool chunked = false;
+    keepAlive = true;
+    contentLength = -1;
+    encoding = ENCODING_IDENTITY;
+    for (;;) {
+        if (!readLine(line, sizeof(line))) return HTTPC_ERROR_READ_TIMEOUT;
+        if (line[0] == '\0') break;  // End of headers
+        if (strncasecmp(line, "Content-Length:", 15) == 0) {
+            contentLength = atol(line + 15);
+        } else if (strncasecmp(line, "Transfer-Encoding:", 18) == 0) {
+            chunked = headerHasToken(line + 18, "chunked");
+        } else if (strncasecmp(line, "Connection:", 11) == 0) {
+            keepAlive = !headerHasToken(line + 11, "close");
+        } else if (strncasecmp(line, "Content-Encoding:", 17) == 0) {
+            const char* value = line + 17;
+            if (headerHasToken(value, "gzip")) encoding = ENCODING_GZIP;
+            else if (headerHasToken(value, "deflate")) encoding = ENCODING_DEFLATE;
+            else if (!headerHasToken(value, "identity")) encoding = ENCODING_UNSUPPORTED;
+        }
+    }
+    // Without a length or chunking the body ends when the server closes
+    if (!chunked && contentLength < 0) keepAlive = false;
+
+    inflater.end();
+    bodyStream.reset(&client, contentLength, chunked, timeoutMs);
+    return statusCode;
+}
+
+Stream& HttpSession::body() {
+    if (encoding == ENCODING_IDENTITY) return bodyStream;
+    // Claimed on first use rather than in receive(), so several sessions can
+    // have replies waiting as long as their bodies are read one after another.
+    // If the inflater is busy or the encoding unknown, the stream reads empty.
+    if (!inflater.active()) inflater.begin(&bodyStream, encoding, timeoutMs);
+    return inflater;
+}
+
+int HttpSession::get(const char* path) {
+    int result = send(path);
+    return result < 0 ? result : receive();
+}
+
+int HttpSession::send(const char* path) {
+    pendingPath = path;
+    reused = client.connected();
+    if (!reused && !connect()) return HTTPC_ERROR_CONNECTION_REFUSED;
+    if (sendRequest(path)) return 0;
+    if (reused) {
+        // The server may have dropped the idle connection; retry once on a fresh one
+        close();
+        reused = false;
+        if (!connect()) return HTTPC_ERROR_CONNECTION_REFUSED;
+        if (sendRequest(path)) return 0;
+    }
+    close();
+    return HTTPC_ERROR_SEND_HEADER_FAILED;
+}
+
+int HttpSession::receive() {
+    int result = readResponseHead();
+    if (result < 0 && reused) {
+        // Same for a connection that was closed before the reply came
+        close();
+        reused = false;
+        if (!connect()) return HTTPC_ERROR_CONNECTION_REFUSED;
+        result = sendRequest(pendingPath) ? readResponseHead() : HTTPC_ERROR_SEND_HEADER_FAILED;
+    }
+    if (result < 0) close();
+    return result;
+}
+
+void HttpSession::end() {
+    inflater.end();
+    if (keepAlive && client.connected()) {
+        unsigned long start = millis();
+        size_t drained = 0;
+        while (!bodyStream.finished() && drained < HTTP_DRAIN_LIMIT &&
+               client.connected() && millis() - start < timeoutMs) {
+            if (bodyStream.read() >= 0) {
+                drained++;
+            } else {
+                delay(1);  // Next byte not in yet
+            }
+        }
+        if (bodyStream.finished()) return;  // Connection ready for the next request
+    }
+    close();
+}
+
+void HttpSession::close() {
+    inflater.end();
+    client.stop();
+    bodyStream.reset(nullptr, 0, false, timeoutMs);
+}
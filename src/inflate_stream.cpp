@@ -0,0 +1,163 @@
+#include "inflate_stream.h"
+#include <rom/miniz.h>
+#include "http_session.h"
+
+// gzip member header flags (RFC 1952)
+#define GZIP_FHCRC 0x02
+#define GZIP_FEXTRA 0x04
+#define GZIP_FNAME 0x08
+#define GZIP_FCOMMENT 0x10
+
+// ~43 KB in .bss, so a compressed reply costs no heap
+static tinfl_decompressor inflater;
+static uint8_t window[TINFL_LZ_DICT_SIZE];
+static InflateStream* inflaterOwner = nullptr;
+
+bool InflateStream::begin(HttpBodyStream* s, ContentEncoding e, unsigned long timeout) {
+    end();
+    source = s;
+    encoding = e;
+    timeoutMs = timeout;
+    started = false;
+    status = TINFL_STATUS_NEEDS_MORE_INPUT;
+    inputPos = inputLength = 0;
+    outputPos = outputEnd = windowPos = 0;
+    failed = inflaterOwner != nullptr || (encoding != ENCODING_GZIP && encoding != ENCODING_DEFLATE);
+    if (failed) return false;
+    inflaterOwner = this;
+    owner = true;
+    return true;
+}
+
+void InflateStream::end() {
+    if (owner) inflaterOwner = nullptr;
+    owner = false;
+}
+
+// Take whatever the socket already has, waiting only for the first byte
+bool InflateStream::fillInput() {
+    inputPos = inputLength = 0;
+    unsigned long start = millis();
+    while (inputLength < sizeof(input)) {
+        int c = source->read();
+        if (c >= 0) {
+            input[inputLength++] = c;
+            continue;
+        }
+        if (inputLength > 0 || source->finished() || millis() - start >= timeoutMs) break;
+        delay(1);
+    }
+    return inputLength > 0;
+}
+
+int InflateStream::nextInput() {
+    if (inputPos == inputLength && !fillInput()) return -1;
+    return input[inputPos++];
+}
+
+bool InflateStream::skipGzipHeader() {
+    uint8_t header[10];
+    for (size_t i = 0; i < sizeof(header); i++) {
+        int c = nextInput();
+        if (c < 0) return false;
+        header[i] = c;
+    }
+    if (header[0] != 0x1f || header[1] != 0x8b || header[2] != 8) return false;
+    uint8_t flags = header[3];
+    if (flags & GZIP_FEXTRA) {
+        int low = nextInput();
+        int high = nextInput();
+        if (high < 0) return false;
+        for (int n = low | (high << 8); n > 0; n--) {
+            if (nextInput() < 0) return false;
+        }
+    }
+    // File name and comment are zero-terminated
+    if (flags & GZIP_FNAME) {
+        int c;
+        while ((c = nextInput()) > 0) {}
+        if (c < 0) return false;
+    }
+    if (flags & GZIP_FCOMMENT) {
+        int c;
+        while ((c = nextInput()) > 0) {}
+        if (c < 0) return false;
+    }
+    if (flags & GZIP_FHCRC) {
+        nextInput();
+        if (nextInput() < 0) return false;
+    }
+    return true;
+}
+
+bool InflateStream::start() {
+    started = true;
+    zlibWrapped = false;
+    if (encoding == ENCODING_GZIP) {
+        if (!skipGzipHeader()) return false;
+    } else {
+        // "deflate" should be zlib-wrapped, but some servers send it raw.
+        // A zlib header has method 8 and is a multiple of 31.
+        if (inputPos == inputLength && !fillInput()) return false;
+        if (inputLength - inputPos >= 2) {
+            uint8_t cmf = input[inputPos];
+            uint8_t flg = input[inputPos + 1];
+            zlibWrapped = (cmf & 0x0f) == 8 && ((cmf << 8) | flg) % 31 == 0;
+        }
+    }
+    tinfl_init(&inflater);
+    return true;
+}
+
+// Inflate the next run of output into the window. False at the end of the
+// data, on a corrupt stream or when the source times out.
+bool InflateStream::refill() {
+    if (failed || !owner) return false;
+    if (!started && !start()) {
+        failed = true;
+        return false;
+    }
+    while (outputPos == outputEnd) {
+        if (status == TINFL_STATUS_DONE) return false;
+        if (status == TINFL_STATUS_NEEDS_MORE_INPUT && inputPos == inputLength &&
+            !fillInput() && !source->finished()) {
+            failed = true;  // Timed out
+            return false;
+        }
+
+        mz_uint32 flags = zlibWrapped ? TINFL_FLAG_PARSE_ZLIB_HEADER : 0;
+        if (!source->finished()) flags |= TINFL_FLAG_HAS_MORE_INPUT;
+        // Output wraps around the window, so each call gets the space up to its end
+        size_t inSize = inputLength - inputPos;
+        size_t outSize = sizeof(window) - windowPos;
+        status = tinfl_decompress(&inflater, input + inputPos, &inSize, window, window + windowPos,
+                                  &outSize, flags);
+        inputPos += inSize;
+        outputPos = windowPos;
+        outputEnd = windowPos + outSize;
+        windowPos = outputEnd & (sizeof(window) - 1);
+
+        bool stalled = outSize == 0 && inputPos == inputLength && source->finished();
+        if (status < 0 || (stalled && status != TINFL_STATUS_DONE)) {
+            failed = true;  // Corrupt or truncated
+            return false;
+        }
+    }
+    return true;
+}
+
+int InflateStream::available() {
+    if (outputPos < outputEnd) return outputEnd - outputPos;
+    if (!owner || failed || status == TINFL_STATUS_DONE) return 0;
+    return inputPos < inputLength || source->available() > 0 ? 1 : 0;
+}
+
+int InflateStream::read() {
+    if (outputPos == outputEnd && !refill()) return -1;
+    return window[outputPos++];
+}
+
+int InflateStream::peek() {
+    if (outputPos == outputEnd && !refill()) return -1;
+    return window[outputPos];
+}
@@ -0,0 +1,19 @@
+#include "json_arena.h"
+
+static uint8_t arena[JSON_ARENA_SIZE] __attribute__((aligned(8)));
+static bool arenaInUse = false;
+
+void* JsonArenaAllocator::allocate(size_t size) {
+    if (arenaInUse || size > sizeof(arena)) return nullptr;
+    arenaInUse = true;
+    return arena;
+}
+
+void JsonArenaAllocator::deallocate(void* pointer) {
+    if (pointer == arena) arenaInUse = false;
+}
+
+// Only shrinkToFit() reallocates; the block stays where it is
+void* JsonArenaAllocator::reallocate(void* pointer, size_t size) {
+    return pointer == arena && size <= sizeof(arena) ? pointer : nullptr;
+}
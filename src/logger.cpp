@@ -0,0 +1,135 @@
+#include "logger.h"
+
+Logger logger;
+
+// Output runs in its own task on the device; the host build writes inline
+#ifdef ESP32
+#define LOG_TASK_CORE 0          // With the network task, away from the renderer
+#define LOG_TASK_STACK 3072
+#define LOG_TASK_PRIORITY 0      // Same as idle: runs only when nothing else wants the core
+#define LOG_DRAIN_INTERVAL 20    // ms between passes over the ring
+
+static void logOutputTask(void* parameter) {
+    for (;;) {
+        logger.drain();
+        vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_INTERVAL));
+    }
+}
+#endif
+
+void Logger::begin(Print& out) {
+    output = &out;
+#ifdef ESP32
+    if (!outputTask) {
+        outputTask = true;
+        xTaskCreatePinnedToCore(logOutputTask, "log", LOG_TASK_STACK, nullptr,
+                                LOG_TASK_PRIORITY, nullptr, LOG_TASK_CORE);
+    }
+#endif
+}
+
+// Claim the next free slot, or count a drop if the ring is full
+Logger::Slot* Logger::reserve() {
+    uint32_t claimed = head.load(std::memory_order_relaxed);
+    do {
+        if (claimed - tail.load(std::memory_order_acquire) >= LOG_QUEUE_LINES) {
+            droppedLines.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+    } while (!head.compare_exchange_weak(claimed, claimed + 1, std::memory_order_acq_rel,
+                                         std::memory_order_relaxed));
+    Slot* slot = &slots[claimed % LOG_QUEUE_LINES];
+    slot->length = 0;
+    return slot;
+}
+
+void Logger::commit(Slot* slot) {
+    slot->ready.store(true, std::memory_order_release);
+    if (!outputTask) drain();
+}
+
+void Logger::printf(const char* format, ...) {
+    Slot* slot = reserve();
+    if (!slot) return;
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(slot->text, sizeof(slot->text), format, args);
+    va_end(args);
+    if (length < 0) length = 0;
+    slot->length = length < (int)sizeof(slot->text) ? length : sizeof(slot->text) - 1;
+    commit(slot);
+}
+
+void Logger::drain() {
+    // Lines go out in the order they were claimed; one still being written
+    // holds back the ones after it until the next pass
+    if (draining.exchange(true, std::memory_order_acquire)) return;
+    uint32_t next = tail.load(std::memory_order_relaxed);
+    bool report = reportState.load(std::memory_order_acquire) == REPORT_READY;
+    while (next != head.load(std::memory_order_acquire)) {
+        if (report && next == reportAfter) {
+            writeReport();
+            report = false;
+        }
+        Slot& slot = slots[next % LOG_QUEUE_LINES];
+        if (!slot.ready.load(std::memory_order_acquire)) break;
+        output->write((const uint8_t*)slot.text, slot.length);
+        output->println();
+        slot.ready.store(false, std::memory_order_relaxed);
+        tail.store(++next, std::memory_order_release);
+    }
+    if (report && next == reportAfter) writeReport();
+
+    uint32_t drops = dropped();
+    if (drops != reportedDrops) {
+        output->printf("log: %lu line(s) dropped\n", (unsigned long)(drops - reportedDrops));
+        reportedDrops = drops;
+    }
+    draining.store(false, std::memory_order_release);
+}
+
+void Logger::writeReport() {
+    output->write((const uint8_t*)reportText, reportLength);
+    reportState.store(REPORT_FREE, std::memory_order_release);
+}
+
+size_t LogLine::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t LogLine::write(const uint8_t* buffer, size_t size) {
+    if (!slot) return size;
+    for (size_t i = 0; i < size && !ended; i++) {
+        if (buffer[i] == '\n' || buffer[i] == '\r') ended = true;
+        else if (slot->length < LOG_LINE_SIZE - 1) slot->text[slot->length++] = buffer[i];
+    }
+    return size;
+}
+
+LogReport::LogReport() {
+    uint8_t expected = Logger::REPORT_FREE;
+    active = logger.reportState.compare_exchange_strong(expected, Logger::REPORT_WRITING,
+                                                        std::memory_order_acquire);
+    if (active) logger.reportLength = 0;
+    else logger.droppedLines.fetch_add(1, std::memory_order_relaxed);
+}
+
+LogReport::~LogReport() {
+    if (!active) return;
+    logger.reportAfter = logger.head.load(std::memory_order_acquire);
+    logger.reportState.store(Logger::REPORT_READY, std::memory_order_release);
+    if (!logger.outputTask) logger.drain();
+}
+
+size_t LogReport::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t LogReport::write(const uint8_t* buffer, size_t size) {
+    if (!active) return size;
+    size_t room = sizeof(logger.reportText) - logger.reportLength;
+    size_t n = size < room ? size : room;
+    memcpy(logger.reportText + logger.reportLength, buffer, n);
+    logger.reportLength += n;
+    return size;
+}
@@ -0,0 +1,223 @@
+#include "mqtt_publisher.h"
+#include "json_writer.h"
+#include "telemetry.h"
+#include "power.h"
+
+MqttPublisher mqttPublisher;
+
+// MQTT 3.1.1 control packet types (high nibble of the fixed header)
+#define MQTT_CONNECT 0x10
+#define MQTT_CONNACK 0x20
+#define MQTT_PUBLISH_QOS1 0x32
+#define MQTT_PUBACK 0x40
+#define MQTT_DISCONNECT 0xE0
+
+void MqttPublisher::begin(const char* h, uint16_t p, const char* u, const char* pw) {
+    host = h;
+    port = p;
+    user = u;
+    password = pw;
+
+    // One topic per display, named after the end of its MAC address
+    uint8_t mac[6] = {};
+    WiFi.macAddress(mac);
+    snprintf(clientId, sizeof(clientId), "aq-%02x%02x%02x", mac[3], mac[4], mac[5]);
+    snprintf(topicName, sizeof(topicName), "%s/%s/telemetry", MQTT_TOPIC, clientId);
+}
+
+size_t buildTelemetryPayload(const SensorSnapshot& readings, unsigned long now, char* out, size_t size) {
+    JsonWriter json(out, size);
+
+    json.printf("{\"up\":%lu,", now / 1000);
+    json.reading("pm", readings.pm25);
+    json.printf("\"n\":%u,", readings.pmStations);
+    json.tenths("pm1h", readings.pmMeanHour);
+    json.tenths("pm24h", readings.pmMeanDay);
+    json.reading("t", readings.temperature);
+    if (readings.weatherVersion != 0) {
+        json.printf("\"wt\":%.1f,\"wp\":%.1f,\"wc\":%d,", readings.currentTemp, readings.currentPressure,
+                    readings.currentWeatherCode);
+    }
+    json.printf("\"age\":{");
+    json.age("pm", readings.pmFetchedAt, now);
+    json.age("t", readings.temperatureFetchedAt, now);
+    json.age("w", readings.weatherFetchedAt, now);
+    json.close('}');
+
+    // Per source: [ok, failed, retries, last error, mean latency ms]
+    json.printf(",\"f\":[");
+    for (int i = 0; i < SOURCE_COUNT; i++) {
+        FetchStats f = telemetry.fetchStats((FetchSource)i);
+        json.printf("[%lu,%lu,%lu,%d,%lu],", (unsigned long)(f.attempts - f.failures), (unsigned long)f.failures,
+                    (unsigned long)f.retries, f.lastError, (unsigned long)f.latencyMs.average());
+    }
+    json.close(']');
+
+    SystemStats system = telemetry.systemStats();
+    WifiStats wifi = telemetry.wifiStats();
+    json.printf(",\"fps\":%.1f,\"late\":%lu,\"skip\":%lu,\"ma\":%lu,\"bri\":%u,"
+                "\"heap\":%lu,\"minheap\":%lu,\"frag\":%u,\"rssi\":%d,\"wifi\":%lu}",
+                telemetry.achievedFps(), (unsigned long)telemetry.lateFrameCount(),
+                (unsigned long)telemetry.skippedFrameCount(), (unsigned long)powerManager.lastCurrent(),
+                FastLED.getBrightness(), (unsigned long)system.freeHeap, (unsigned long)system.minFreeHeap,
+                system.fragmentation(), WiFi.RSSI(), (unsigned long)wifi.losses);
+
+    return json.overflow() ? 0 : json.written();
+}
+
+void MqttPublisher::sample(const SensorSnapshot& readings, unsigned long now) {
+    // Full: the oldest batch makes room
+    Batch* slot;
+    {
+        SpinLockGuard lock(statsLock);
+        if (count < MQTT_QUEUE_SIZE) {
+            slot = &queue[(head + count) % MQTT_QUEUE_SIZE];
+            count++;
+        } else {
+            slot = &queue[head];
+            head = (head + 1) % MQTT_QUEUE_SIZE;
+            counters.dropped++;
+        }
+    }
+    // Only this task reads the batches, so the payload is written unlocked
+    slot->takenAt = now;
+    slot->length = buildTelemetryPayload(readings, now, slot->payload, sizeof(slot->payload));
+    lastSample = now;
+}
+
+void MqttPublisher::update(const SensorSnapshot& readings, unsigned long now, bool fetched) {
+    if (!enabled()) return;
+    if (interval == 0 ? fetched : now - lastSample >= interval) sample(readings, now);
+    if (count == 0 || WiFi.status() != WL_CONNECTED) return;
+
+    // Piggyback on a fetch, which just had the radio up; otherwise only
+    // once the oldest batch has waited long enough. After a failure, wait
+    // for the retry time or the next fetch.
+    bool due = fetched || now - queue[head].takenAt >= MQTT_FLUSH_DELAY;
+    if (retryPending && !fetched && (long)(now - retryAt) < 0) due = false;
+    if (!due) return;
+
+    retryPending = !flush();
+    if (retryPending) retryAt = now + MQTT_RETRY_INTERVAL;
+}
+
+// Length-prefixed UTF-8 string at packet[at]; returns the position after it
+size_t MqttPublisher::putString(size_t at, const char* text) {
+    size_t length = strlen(text);
+    packet[at] = length >> 8;
+    packet[at + 1] = length & 0xFF;
+    memcpy(packet + at + 2, text, length);
+    return at + 2 + length;
+}
+
+// packet[5..length) holds the variable header and payload; prepend the
+// fixed header (type already in packet[0]) right before it and send
+bool MqttPublisher::send(size_t length) {
+    size_t remaining = length - 5;
+    uint8_t header[5];
+    size_t headerLength = 0;
+    header[headerLength++] = packet[0];
+    do {
+        uint8_t digit = remaining % 128;
+        remaining /= 128;
+        header[headerLength++] = digit | (remaining > 0 ? 0x80 : 0);
+    } while (remaining > 0 && headerLength < sizeof(header));
+    uint8_t* start = packet + 5 - headerLength;
+    memcpy(start, header, headerLength);
+    size_t total = length - 5 + headerLength;
+    return client.write(start, total) == total;
+}
+
+// Read a two-byte acknowledgement packet of the given type
+bool MqttPublisher::readAck(uint8_t type, uint8_t* body) {
+    uint8_t ack[4];
+    size_t received = 0;
+    unsigned long start = millis();
+    while (received < sizeof(ack)) {
+        int c = client.read();
+        if (c < 0) {
+            if (!client.connected() || millis() - start >= MQTT_ACK_TIMEOUT) return false;
+            delay(1);
+            continue;
+        }
+        ack[received++] = c;
+    }
+    if ((ack[0] & 0xF0) != type || ack[1] != 2) return false;
+    body[0] = ack[2];
+    body[1] = ack[3];
+    return true;
+}
+
+bool MqttPublisher::connect() {
+    size_t credentials = (user ? strlen(user) + 2 : 0) + (password ? strlen(password) + 2 : 0);
+    if (credentials > sizeof(packet) - 64) return false;
+    if (!client.connect(host, port)) return false;
+    client.setNoDelay(true);
+
+    uint8_t flags = 0x02;  // Clean session: nothing is left on the broker between flushes
+    if (user) flags |= 0x80;
+    if (user && password) flags |= 0x40;
+
+    packet[0] = MQTT_CONNECT;
+    size_t at = putString(5, "MQTT");
+    packet[at++] = 4;  // Protocol level 3.1.1
+    packet[at++] = flags;
+    packet[at++] = 0;
+    packet[at++] = MQTT_KEEPALIVE;
+    at = putString(at, clientId);
+    if (user) at = putString(at, user);
+    if (user && password) at = putString(at, password);
+
+    uint8_t ack[2];
+    return send(at) && readAck(MQTT_CONNACK, ack) && ack[1] == 0;
+}
+
+bool MqttPublisher::publish(const Batch& batch) {
+    if (++packetId == 0) packetId = 1;
+    packet[0] = MQTT_PUBLISH_QOS1;
+    size_t at = putString(5, topicName);
+    packet[at++] = packetId >> 8;
+    packet[at++] = packetId & 0xFF;
+    memcpy(packet + at, batch.payload, batch.length);
+    at += batch.length;
+
+    uint8_t ack[2];
+    return send(at) && readAck(MQTT_PUBACK, ack) && ((ack[0] << 8) | ack[1]) == packetId;
+}
+
+void MqttPublisher::countFailure() {
+    SpinLockGuard lock(statsLock);
+    counters.failures++;
+}
+
+MqttStats MqttPublisher::stats() const {
+    SpinLockGuard lock(statsLock);
+    MqttStats copy = counters;
+    copy.queued = count;
+    return copy;
+}
+
+bool MqttPublisher::flush() {
+    if (count == 0) return true;
+    if (!connect()) {
+        countFailure();
+        client.stop();
+        return false;
+    }
+    while (count > 0) {
+        const Batch& batch = queue[head];
+        // A sample that didn't fit is dropped rather than sent half-written
+        if (batch.length > 0 && !publish(batch)) {
+            countFailure();
+            break;
+        }
+        SpinLockGuard lock(statsLock);
+        if (batch.length > 0) counters.published++;
+        head = (head + 1) % MQTT_QUEUE_SIZE;
+        count--;
+    }
+    static const uint8_t disconnect[] = {MQTT_DISCONNECT, 0};
+    client.write(disconnect, sizeof(disconnect));
+    client.stop();
+    return count == 0;
+}
@@ -0,0 +1,100 @@
+#include "poll_scheduler.h"
+#include "logger.h"
+
+static const char* const SOURCE_LABELS[SOURCE_COUNT] = {"PM2.5", "temperature", "weather"};
+
+// Days since 2000-01-01 for a civil date (proleptic Gregorian)
+static int32_t daysSince2000(int year, int month, int day) {
+    year -= month <= 2;
+    int32_t era = year / 400;
+    int32_t yearOfEra = year - era * 400;
+    int32_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int32_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 730425;
+}
+
+uint32_t parseTimestamp(const char* timestamp) {
+    int year, month, day, hour, minute, second = 0;
+    if (sscanf(timestamp, "%d-%d-%d%*c%d:%d:%d", &year, &month, &day, &hour, &minute, &second) < 5) {
+        return 0;
+    }
+    if (year < 2000 || month < 1 || month > 12 || day < 1 || day > 31) return 0;
+    return (uint32_t)daysSince2000(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+void PollScheduler::configure(FetchSource source, unsigned long cadence, unsigned long minInterval,
+                              unsigned long maxInterval) {
+    Source& s = sources[source];
+    s.cadence = cadence;
+    s.minInterval = minInterval;
+    s.maxInterval = maxInterval;
+    s.dueAt = millis() + source * POLL_SPACING;  // Staggered first fetches
+    s.active = true;
+}
+
+void PollScheduler::schedule(Source& s, unsigned long now, unsigned long delay) {
+    if (delay < s.minInterval) delay = s.minInterval;
+    if (delay > s.maxInterval) delay = s.maxInterval;
+    s.dueAt = now + delay;
+}
+
+int PollScheduler::nextDue(unsigned long now) {
+    if (fetched && now - lastFetch < POLL_SPACING) return -1;
+
+    // Most overdue first
+    int best = -1;
+    long bestLate = -1;
+    for (int i = 0; i < SOURCE_COUNT; i++) {
+        long late = (long)(now - sources[i].dueAt);
+        if (sources[i].active && late >= 0 && late > bestLate) {
+            best = i;
+            bestLate = late;
+        }
+    }
+    return best;
+}
+
+void PollScheduler::complete(int source, FetchResult result, uint32_t upstreamTime, unsigned long now) {
+    Source& s = sources[source];
+    lastFetch = now;
+    fetched = true;
+
+    if (result == FETCH_ERROR) {
+        unsigned long delay = POLL_ERROR_BACKOFF;
+        for (uint8_t i = 0; i < s.errors && delay < s.maxInterval; i++) delay *= 2;
+        if (s.errors < 255) s.errors++;
+        schedule(s, now, delay);
+        LOG_INFO("Next %s fetch in %lu s (error %u)", SOURCE_LABELS[source],
+                 (s.dueAt - now) / 1000, s.errors);
+        return;
+    }
+    s.errors = 0;
+
+    if (result == FETCH_UNCHANGED || upstreamTime == 0) {
+        // Polled a little early; look again soon instead of waiting a whole
+        // period, backing off if the upstream has gone quiet
+        unsigned long delay = s.cadence / POLL_RECHECK_DIVISOR;
+        for (uint8_t i = 0; i < s.misses && delay < s.maxInterval; i++) delay *= 2;
+        if (s.misses < 255) s.misses++;
+        schedule(s, now, delay);
+        return;
+    }
+    s.misses = 0;
+
+    // A new reading: fold the observed gap into the cadence estimate. Gaps
+    // over twice the estimate mean readings were missed, so they only nudge it.
+    if (s.lastUpstream != 0 && upstreamTime > s.lastUpstream) {
+        unsigned long observed = (upstreamTime - s.lastUpstream) * 1000UL;
+        if (observed > 2 * s.cadence) observed = 2 * s.cadence;
+        s.cadence = (3 * s.cadence + observed) / 4;
+        if (s.cadence < s.minInterval) s.cadence = s.minInterval;
+        if (s.cadence > s.maxInterval) s.cadence = s.maxInterval;
+    }
+    s.lastUpstream = upstreamTime;
+
+    // The next reading is due one cadence after this one appeared, which
+    // was at most a recheck interval before now
+    schedule(s, now, s.cadence);
+    LOG_INFO("Next %s fetch in %lu s (cadence %lu s)", SOURCE_LABELS[source],
+             (s.dueAt - now) / 1000, s.cadence / 1000);
+}
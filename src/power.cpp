@@ -0,0 +1,50 @@
+#include "power.h"
+
+PowerManager powerManager;
+
+// Channel sums weighted by their full-drive current, in mA * 255
+static uint32_t weightedSum(const CRGB* leds, int count) {
+    uint32_t red = 0, green = 0, blue = 0;
+    for (int i = 0; i < count; i++) {
+        red += leds[i].r;
+        green += leds[i].g;
+        blue += leds[i].b;
+    }
+    return red * LED_RED_MA + green * LED_GREEN_MA + blue * LED_BLUE_MA;
+}
+
+int localMinuteOfDay(const SensorSnapshot& readings, unsigned long now) {
+    if (readings.pmFetchedAt == 0) return -1;
+    int hour, minute;
+    if (sscanf(readings.localTime, "%*d-%*d-%*d %d:%d", &hour, &minute) != 2) return -1;
+    unsigned long elapsed = (now - readings.pmFetchedAt) / 60000;
+    return (hour * 60 + minute + elapsed) % (24 * 60);
+}
+
+void PowerManager::setSchedule(uint8_t dayLevel, uint8_t nightLevel, uint8_t nightStartHour, uint8_t nightEndHour) {
+    day = dayLevel;
+    night = nightLevel;
+    nightStart = nightStartHour;
+    nightEnd = nightEndHour;
+}
+
+bool PowerManager::isNight() const {
+    if (clock < 0 || nightStart == nightEnd) return false;
+    int hour = clock / 60;
+    return nightStart < nightEnd ? hour >= nightStart && hour < nightEnd
+                                 : hour >= nightStart || hour < nightEnd;  // Across midnight
+}
+
+uint8_t PowerManager::frameBrightness(const CRGB* leds, int count) {
+    uint8_t level = isNight() ? night : day;
+    uint32_t weighted = weightedSum(leds, count);
+    uint32_t idle = count * LED_IDLE_MA;
+
+    // Highest brightness whose estimate fits the budget
+    if (budget > 0 && weighted > 0) {
+        uint32_t limit = budget > idle ? (uint32_t)((uint64_t)(budget - idle) * 255 * 255 / weighted) : 0;
+        if (limit < level) level = limit;
+    }
+    current = idle + (uint32_t)((uint64_t)weighted * level / (255 * 255));
+    return level;
+}
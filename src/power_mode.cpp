@@ -0,0 +1,201 @@
+#include "power_mode.h"
+#include "power.h"
+#include "logger.h"
+
+#ifdef ESP32
+#include <WiFi.h>
+#include <esp_pm.h>
+#include <esp_idf_version.h>
+#endif
+
+PowerMode powerMode;
+
+static const char* const MODE_NAMES[POWER_MODE_COUNT] = {"full", "low"};
+
+#ifdef ESP32
+// Counted locks: while any is held the chip neither slows down nor sleeps
+static esp_pm_lock_handle_t renderLock = nullptr;    // Loop, between idles
+static esp_pm_lock_handle_t transferLock = nullptr;  // Network task, during a fetch
+static esp_pm_lock_handle_t outputLock = nullptr;    // LED frame on the wire
+
+static void acquire(esp_pm_lock_handle_t lock) {
+    if (lock) esp_pm_lock_acquire(lock);
+}
+
+static void release(esp_pm_lock_handle_t lock) {
+    if (lock) esp_pm_lock_release(lock);
+}
+
+static esp_err_t configurePm(int maxMhz, int minMhz, bool sleep) {
+#if ESP_IDF_VERSION_MAJOR >= 5
+    esp_pm_config_t config = {};
+#else
+    esp_pm_config_esp32s3_t config = {};
+#endif
+    config.max_freq_mhz = maxMhz;
+    config.min_freq_mhz = minMhz;
+    config.light_sleep_enable = sleep;
+    return esp_pm_configure(&config);
+}
+#endif
+
+void PowerMode::begin(uint8_t mode) {
+#ifdef ESP32
+    // Without CONFIG_PM_ENABLE the locks are unavailable and stay null
+    if (!renderLock) {
+        if (esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "render", &renderLock) != ESP_OK) renderLock = nullptr;
+        if (esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "transfer", &transferLock) != ESP_OK) transferLock = nullptr;
+        if (esp_pm_lock_create(ESP_PM_APB_FREQ_MAX, 0, "leds", &outputLock) != ESP_OK) outputLock = nullptr;
+        acquire(renderLock);
+    }
+#endif
+    accountedAt = millis();
+    started = true;
+    set(mode);
+}
+
+bool PowerMode::set(uint8_t mode) {
+    if (mode >= POWER_MODE_COUNT) return false;
+    if (started) account(millis());
+    current = mode;
+    apply();
+    LOG_INFO("Power: %s%s%s", MODE_NAMES[current], scaling ? ", clock scaling" : "",
+             lightSleep ? ", light sleep" : "");
+    return true;
+}
+
+// Put the clock and radio settings of the current mode into effect
+void PowerMode::apply() {
+    scaling = lightSleep = false;
+#ifdef ESP32
+    if (current == POWER_LOW) {
+        // Light sleep needs tickless idle in the IDF build; fall back to
+        // clock scaling alone, then to a fixed lower clock
+        if (configurePm(LOW_POWER_CPU_MAX_MHZ, LOW_POWER_CPU_MIN_MHZ, true) == ESP_OK) {
+            scaling = lightSleep = true;
+        } else if (configurePm(LOW_POWER_CPU_MAX_MHZ, LOW_POWER_CPU_MIN_MHZ, false) == ESP_OK) {
+            scaling = true;
+        } else {
+            setCpuFrequencyMhz(LOW_POWER_CPU_MAX_MHZ);
+        }
+        WiFi.setSleep(WIFI_PS_MAX_MODEM);
+    } else {
+        int fullMhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+        if (configurePm(fullMhz, fullMhz, false) != ESP_OK) setCpuFrequencyMhz(fullMhz);
+        WiFi.setSleep(WIFI_PS_MIN_MODEM);
+    }
+#endif
+}
+
+void PowerMode::idleUntil(unsigned long deadline) {
+    unsigned long now = millis();
+    if (current == POWER_FULL) {
+        delay(1);  // Let the idle task and WiFi stack run
+    } else {
+        long wait = (long)(deadline - now);
+        if (wait < 1) wait = 1;
+        if (wait > LOW_POWER_MAX_IDLE) wait = LOW_POWER_MAX_IDLE;
+#ifdef ESP32
+        // Released only while blocked, so frames still render at full clock
+        release(renderLock);
+        vTaskDelay(pdMS_TO_TICKS(wait));
+        acquire(renderLock);
+#else
+        delay(wait);
+#endif
+    }
+    unsigned long end = millis();
+    idleMs += end - now;
+    account(end);
+}
+
+void PowerMode::beginTransfer() {
+#ifdef ESP32
+    acquire(transferLock);
+    if (current == POWER_LOW) WiFi.setSleep(WIFI_PS_NONE);
+#endif
+    transferStart = millis();
+}
+
+void PowerMode::endTransfer() {
+#ifdef ESP32
+    if (current == POWER_LOW) WiFi.setSleep(WIFI_PS_MAX_MODEM);
+    release(transferLock);
+#endif
+    transferMs.fetch_add(millis() - transferStart, std::memory_order_relaxed);
+}
+
+void PowerMode::beginOutput() {
+#ifdef ESP32
+    acquire(outputLock);
+#endif
+}
+
+void PowerMode::endOutput() {
+#ifdef ESP32
+    release(outputLock);
+#endif
+}
+
+// Charge the time since the last call to the current mode. The loop is
+// awake whenever it isn't idling; a transfer keeps the chip awake too.
+void PowerMode::account(unsigned long now) {
+    uint32_t elapsed = now - accountedAt;
+    if (elapsed == 0) return;
+    uint32_t radio = transferMs.exchange(0, std::memory_order_relaxed);
+    if (radio > elapsed) radio = elapsed;
+    uint32_t idle = idleMs < elapsed ? idleMs : elapsed;
+    uint32_t awake = elapsed - idle > radio ? elapsed - idle : radio;
+    accountedAt = now;
+    idleMs = 0;
+
+    bool low = current == POWER_LOW;
+    uint32_t mhz = low ? LOW_POWER_CPU_MAX_MHZ : getCpuFrequencyMhz();
+    uint64_t charge = (uint64_t)awake * (BOARD_CPU_BASE_MA + BOARD_CPU_UA_PER_MHZ * mhz / 1000);
+    charge += (uint64_t)(elapsed - awake) * (lightSleep ? BOARD_LIGHT_SLEEP_MA : BOARD_IDLE_MA);
+    charge += (uint64_t)radio * BOARD_RADIO_ON_MA;
+    charge += (uint64_t)(elapsed - radio) * (low ? BOARD_RADIO_SLEEP_MA : BOARD_RADIO_IDLE_MA);
+
+    PowerResidency& r = modes[current];
+    r.ms += elapsed;
+    r.awakeMs += awake;
+    r.radioMs += radio;
+    r.boardMaMs += charge;
+    r.ledMaMs += (uint64_t)elapsed * powerManager.lastCurrent();
+}
+
+uint32_t PowerMode::averageCurrent(uint8_t mode) const {
+    const PowerResidency& r = modes[mode];
+    return r.ms ? r.boardMaMs / r.ms : 0;
+}
+
+uint32_t PowerMode::averageLedCurrent(uint8_t mode) const {
+    const PowerResidency& r = modes[mode];
+    return r.ms ? r.ledMaMs / r.ms : 0;
+}
+
+void PowerMode::printSummary(Print& out) {
+    account(millis());
+    const PowerResidency& r = modes[current];
+    out.printf("power: %s, est. %lu mA board + %lu mA LEDs (awake %lu%%, radio %lu%%)\n",
+               MODE_NAMES[current], (unsigned long)averageCurrent(current),
+               (unsigned long)averageLedCurrent(current),
+               (unsigned long)(r.ms ? (uint64_t)r.awakeMs * 100 / r.ms : 0),
+               (unsigned long)(r.ms ? (uint64_t)r.radioMs * 100 / r.ms : 0));
+}
+
+void PowerMode::printReport(Print& out) {
+    account(millis());
+    out.printf("Power mode: %s%s%s (estimated from time in each state)\n", MODE_NAMES[current],
+               scaling ? ", clock scaling" : "", lightSleep ? ", light sleep" : "");
+    for (int i = 0; i < POWER_MODE_COUNT; i++) {
+        const PowerResidency& r = modes[i];
+        if (r.ms == 0) continue;
+        out.printf("  %-4s %8lu s  board %3lu mA  LEDs %4lu mA  total %4lu mA  awake %lu%%  radio %lu%%\n",
+                   MODE_NAMES[i], (unsigned long)(r.ms / 1000), (unsigned long)averageCurrent(i),
+                   (unsigned long)averageLedCurrent(i),
+                   (unsigned long)(averageCurrent(i) + averageLedCurrent(i)),
+                   (unsigned long)((uint64_t)r.awakeMs * 100 / r.ms),
+                   (unsigned long)((uint64_t)r.radioMs * 100 / r.ms));
+    }
+}
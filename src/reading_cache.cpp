@@ -0,0 +1,61 @@
+#include <Preferences.h>
+#include "reading_cache.h"
+
+// Stored as one blob; version and size reject a layout from older firmware
+struct CachedReadings {
+    uint16_t version;
+    uint16_t size;
+    SensorSnapshot readings;
+};
+
+static CachedReadings lastSaved;
+static bool haveSaved = false;        // lastSaved matches what is in flash
+static bool writtenSinceBoot = false;
+static unsigned long lastWriteTime = 0;
+
+bool loadCachedReadings(SensorSnapshot& out) {
+    Preferences prefs;
+    if (!prefs.begin(CACHE_NAMESPACE, true)) return false;
+    CachedReadings blob;
+    size_t length = prefs.getBytes("snapshot", &blob, sizeof(blob));
+    prefs.end();
+
+    if (length != sizeof(blob) || blob.version != CACHE_VERSION || blob.size != sizeof(SensorSnapshot)) {
+        return false;
+    }
+    lastSaved = blob;
+    haveSaved = true;
+    out = blob.readings;
+    out.restored = true;
+    out.pmFetchedAt = 0;  // millis() of another boot
+    out.temperatureFetchedAt = 0;
+    out.weatherFetchedAt = 0;
+    return true;
+}
+
+bool saveCachedReadings(const SensorSnapshot& readings) {
+    CachedReadings blob;
+    memset((void*)&blob, 0, sizeof(blob));  // Zero the padding so memcmp is meaningful
+    blob.version = CACHE_VERSION;
+    blob.size = sizeof(SensorSnapshot);
+    blob.readings = readings;
+    blob.readings.restored = false;
+
+    if (haveSaved && memcmp(&blob, &lastSaved, sizeof(blob)) == 0) return false;
+    // The first write after boot goes through, later ones are rate-limited
+    if (writtenSinceBoot && millis() - lastWriteTime < CACHE_WRITE_INTERVAL) return false;
+
+    Preferences prefs;
+    if (!prefs.begin(CACHE_NAMESPACE, false)) return false;
+    bool ok = prefs.putBytes("snapshot", &blob, sizeof(blob)) == sizeof(blob);
+    prefs.end();
+
+    // Count failed writes too, so a bad flash sector isn't hammered every call
+    writtenSinceBoot = true;
+    lastWriteTime = millis();
+    if (ok) {
+        lastSaved = blob;
+        haveSaved = true;
+    }
+    return ok;
+}
@@ -0,0 +1,165 @@
+#include "status_server.h"
+#include "telemetry.h"
+#include "ticker.h"
+#include "history.h"
+#include "json_writer.h"
+#include "power.h"
+#include "mqtt_publisher.h"
+
+StatusServer statusServer;
+
+static const char* const SOURCE_NAMES[SOURCE_COUNT] = {"pm", "temperature", "weather"};
+
+void StatusServer::begin(const SeqLock<SensorSnapshot>* source) {
+    readings = source;
+    server.begin();
+    server.setNoDelay(true);
+}
+
+size_t buildStatusJson(const SensorSnapshot& snapshot, char* out, size_t size) {
+    unsigned long now = millis();
+    JsonWriter json(out, size);
+
+    json.printf("{\"uptime\":%lu,", now / 1000);
+    json.reading("pm25", snapshot.pm25);
+    json.printf("\"pm25_stations\":%u,", snapshot.pmStations);
+    json.reading("temperature", snapshot.temperature);
+    json.reading("altitude", snapshot.altitude);
+    json.printf("\"time\":\"%s\",\"restored\":%s,", snapshot.localTime, snapshot.restored ? "true" : "false");
+
+    json.printf("\"history\":{");
+    json.tenths("pm25_1h", snapshot.pmMeanHour);
+    json.tenths("pm25_24h", snapshot.pmMeanDay);
+    json.printf("\"pm25_trend\":%d,", snapshot.pmTrend);
+    json.tenths("temperature_min_24h", snapshot.temperatureMinDay);
+    json.tenths("temperature_max_24h", snapshot.temperatureMaxDay);
+    json.close('}');
+
+    json.printf(",\"weather\":{");
+    if (snapshot.weatherVersion != 0) {
+        json.printf("\"temperature\":%.1f,\"pressure\":%.1f,\"code\":%d,\"description\":\"%s\",",
+                    snapshot.currentTemp, snapshot.currentPressure, snapshot.currentWeatherCode,
+                    getWeatherDescription(snapshot.currentWeatherCode));
+        json.printf("\"tomorrow\":{\"min\":%.1f,\"max\":%.1f,\"code\":%d,\"description\":\"%s\"}",
+                    snapshot.tomorrowMinTemp, snapshot.tomorrowMaxTemp, snapshot.tomorrowWeatherCode,
+                    getWeatherDescription(snapshot.tomorrowWeatherCode));
+    }
+    json.close('}');
+
+    json.printf(",\"age\":{");
+    json.age("pm25", snapshot.pmFetchedAt, now);
+    json.age("temperature", snapshot.temperatureFetchedAt, now);
+    json.age("weather", snapshot.weatherFetchedAt, now);
+    json.close('}');
+
+    json.printf(",\"fetch\":{");
+    for (int i = 0; i < SOURCE_COUNT; i++) {
+        FetchStats f = telemetry.fetchStats((FetchSource)i);
+        json.printf("\"%s\":{\"ok\":%lu,\"failed\":%lu,\"retries\":%lu,\"last_error\":%d,\"latency_ms\":%lu},",
+                    SOURCE_NAMES[i], (unsigned long)(f.attempts - f.failures), (unsigned long)f.failures,
+                    (unsigned long)f.retries, f.lastError, (unsigned long)f.latencyMs.average());
+    }
+    json.close('}');
+
+    WifiStats wifi = telemetry.wifiStats();
+    json.printf(",\"wifi\":{\"connected\":%s,\"rssi\":%d,\"connects\":%lu,\"attempts\":%lu,\"losses\":%lu,"
+                "\"last_reason\":%u}",
+                WiFi.status() == WL_CONNECTED ? "true" : "false", WiFi.RSSI(), (unsigned long)wifi.connects,
+                (unsigned long)wifi.attempts, (unsigned long)wifi.losses, wifi.lastReason);
+
+    json.printf(",\"display\":{\"fps\":%.1f,\"late\":%lu,\"unchanged\":%lu,\"brightness\":%u,\"night\":%s,"
+                "\"led_ma\":%lu,\"led_ma_max\":%lu}",
+                telemetry.achievedFps(), (unsigned long)telemetry.lateFrameCount(),
+                (unsigned long)telemetry.skippedFrameCount(), FastLED.getBrightness(),
+                powerManager.isNight() ? "true" : "false", (unsigned long)powerManager.lastCurrent(),
+                (unsigned long)telemetry.maxLedCurrent());
+
+    if (mqttPublisher.enabled()) {
+        MqttStats mqtt = mqttPublisher.stats();
+        json.printf(",\"mqtt\":{\"topic\":\"%s\",\"published\":%lu,\"queued\":%u,\"dropped\":%lu,\"failures\":%lu}",
+                    mqttPublisher.topic(), (unsigned long)mqtt.published, mqtt.queued,
+                    (unsigned long)mqtt.dropped, (unsigned long)mqtt.failures);
+    }
+
+    SystemStats system = telemetry.systemStats();
+    json.printf(",\"heap\":{\"free\":%lu,\"min_free\":%lu,\"largest_block\":%lu,\"lowest_largest_block\":%lu,"
+                "\"fragmentation\":%u}}\n",
+                (unsigned long)system.freeHeap, (unsigned long)system.minFreeHeap,
+                (unsigned long)system.largestFreeBlock, (unsigned long)system.lowestLargestBlock,
+                system.fragmentation());
+
+    return json.overflow() ? 0 : json.written();
+}
+
+// Read the request line and skip the headers. Only the path is kept.
+bool StatusServer::readRequest(WiFiClient& client, char* path, size_t size) {
+    char line[128];
+    size_t lineLength = 0;
+    bool firstLine = true;
+    unsigned long start = millis();
+
+    while (client.connected() && millis() - start < STATUS_REQUEST_TIMEOUT) {
+        int c = client.read();
+        if (c < 0) {
+            delay(1);
+            continue;
+        }
+        if (c == '\r') continue;
+        if (c != '\n') {
+            if (lineLength < sizeof(line) - 1) line[lineLength++] = c;
+            continue;
+        }
+        line[lineLength] = '\0';
+        if (lineLength == 0) return !firstLine;  // Blank line: end of headers
+        if (firstLine) {
+            // "GET /status HTTP/1.1"
+            char* target = strchr(line, ' ');
+            if (!target || strncmp(line, "GET ", 4) != 0) return false;
+            target++;
+            char* end = strchr(target, ' ');
+            if (end) *end = '\0';
+            char* query = strchr(target, '?');
+            if (query) *query = '\0';
+            strncpy(path, target, size - 1);
+            path[size - 1] = '\0';
+            firstLine = false;
+        }
+        lineLength = 0;
+    }
+    return false;
+}
+
+void StatusServer::respond(WiFiClient& client, const char* status, const char* body, size_t length) {
+    char header[192];
+    int n = snprintf(header, sizeof(header),
+                     "HTTP/1.1 %s\r\nContent-Type: application/json\r\nContent-Length: %u\r\n"
+                     "Cache-Control: no-cache\r\nAccess-Control-Allow-Origin: *\r\nConnection: close\r\n\r\n",
+                     status, (unsigned)length);
+    client.write((const uint8_t*)header, n);
+    client.write((const uint8_t*)body, length);
+}
+
+bool StatusServer::poll() {
+    WiFiClient client = server.available();
+    if (!client) return false;
+
+    char path[64];
+    if (!readRequest(client, path, sizeof(path))) {
+        static const char error[] = "{\"error\":\"bad request\"}\n";
+        respond(client, "400 Bad Request", error, sizeof(error) - 1);
+    } else if (strcmp(path, "/") == 0 || strcmp(path, "/status") == 0) {
+        readings->read(snapshot);
+        size_t length = buildStatusJson(snapshot, body, sizeof(body));
+        if (length > 0) {
+            respond(client, "200 OK", body, length);
+        } else {
+            static const char error[] = "{\"error\":\"response too large\"}\n";
+            respond(client, "500 Internal Server Error", error, sizeof(error) - 1);
+        }
+    } else {
+        static const char error[] = "{\"error\":\"not found\"}\n";
+        respond(client, "404 Not Found", error, sizeof(error) - 1);
+    }
+    client.stop();
+    return true;
+}
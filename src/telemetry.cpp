@@ -0,0 +1,299 @@
+#include "telemetry.h"
+#include "logger.h"
+#include "snapshot.h"
+
+Telemetry telemetry;
+
+static const char* const SOURCE_NAMES[SOURCE_COUNT] = {"pm", "temp", "wx"};
+
+// Guards every record and read; printing happens outside it
+static SpinLock statsLock;
+
+// Buckets 0-3 hold 0-3 exactly; above that, four buckets per power of two
+int Histogram::bucketFor(uint32_t value) {
+    if (value < 4) return value;
+    int msb = 31 - __builtin_clz(value);
+    int sub = (value >> (msb - 2)) & 3;
+    int bucket = 4 * (msb - 1) + sub;
+    return bucket < BUCKETS ? bucket : BUCKETS - 1;
+}
+
+uint32_t Histogram::bucketUpper(int bucket) {
+    if (bucket < 4) return bucket;
+    int msb = bucket / 4 + 1;
+    uint32_t lower = (uint32_t)(4 + bucket % 4) << (msb - 2);
+    return lower + (1u << (msb - 2)) - 1;
+}
+
+void Histogram::record(uint32_t value) {
+    buckets[bucketFor(value)]++;
+    samples++;
+    sum += value;
+    if (value < minValue) minValue = value;
+    if (value > maxValue) maxValue = value;
+}
+
+void Histogram::reset() {
+    memset(buckets, 0, sizeof(buckets));
+    samples = 0;
+    minValue = UINT32_MAX;
+    maxValue = 0;
+    sum = 0;
+}
+
+uint32_t Histogram::percentile(uint8_t p) const {
+    if (samples == 0) return 0;
+    uint32_t target = (uint32_t)(((uint64_t)samples * p + 99) / 100);
+    uint32_t seen = 0;
+    for (int b = 0; b < BUCKETS; b++) {
+        seen += buckets[b];
+        if (seen >= target) {
+            uint32_t upper = bucketUpper(b);
+            return upper < maxValue ? upper : maxValue;
+        }
+    }
+    return maxValue;
+}
+
+HistogramSummary Histogram::summary() const {
+    return {count(), min(), average(), percentile(99), max()};
+}
+
+void Telemetry::recordFrame(uint32_t render) {
+    unsigned long now = millis();
+    SpinLockGuard lock(statsLock);
+    if (windowStart == 0) windowStart = now;
+    renderUs.record(render);
+}
+
+void Telemetry::recordShow(uint32_t show) {
+    SpinLockGuard lock(statsLock);
+    showUs.record(show);
+}
+
+void Telemetry::recordLateFrame() {
+    SpinLockGuard lock(statsLock);
+    lateFrames++;
+}
+
+void Telemetry::recordSkippedFrame() {
+    SpinLockGuard lock(statsLock);
+    skippedFrames++;
+}
+
+void Telemetry::recordPower(uint32_t milliamps) {
+    SpinLockGuard lock(statsLock);
+    ledMa.record(milliamps);
+}
+
+void Telemetry::recordFetch(FetchSource source, bool ok, uint32_t latencyMs, int retries, int error) {
+    SpinLockGuard lock(statsLock);
+    FetchStats& stats = fetches[source];
+    stats.attempts++;
+    stats.retries += retries;
+    stats.latencyMs.record(latencyMs);
+    if (ok) return;
+
+    stats.failures++;
+    stats.lastError = error;
+    if (error == FETCH_ERROR_PARSE) {
+        stats.parseErrors++;
+    } else if (error > 0) {
+        stats.httpErrors++;
+    } else {
+        stats.transportErrors[(error < 0 && error >= -11) ? -error : 0]++;
+    }
+}
+
+void Telemetry::recordWifiAttempt() {
+    SpinLockGuard lock(statsLock);
+    wifi.attempts++;
+}
+
+void Telemetry::recordWifiFailure(uint8_t reason) {
+    SpinLockGuard lock(statsLock);
+    wifi.failures++;
+    if (reason) wifi.lastReason = reason;
+}
+
+void Telemetry::recordWifiConnected(uint32_t offlineMs) {
+    SpinLockGuard lock(statsLock);
+    wifi.connects++;
+    wifi.reconnectMs.record(offlineMs);
+}
+
+void Telemetry::recordWifiLost(uint8_t reason) {
+    SpinLockGuard lock(statsLock);
+    wifi.losses++;
+    wifi.lastReason = reason;
+}
+
+// A largest block that keeps shrinking over days means the heap is fragmenting
+void Telemetry::setSystemStats(const SystemStats& stats) {
+    SpinLockGuard lock(statsLock);
+    uint32_t lowest = system.lowestLargestBlock;
+    system = stats;
+    system.lowestLargestBlock =
+        lowest && lowest < stats.largestFreeBlock ? lowest : stats.largestFreeBlock;
+}
+
+FetchStats Telemetry::fetchStats(FetchSource source) const {
+    SpinLockGuard lock(statsLock);
+    return fetches[source];
+}
+
+WifiStats Telemetry::wifiStats() const {
+    SpinLockGuard lock(statsLock);
+    return wifi;
+}
+
+SystemStats Telemetry::systemStats() const {
+    SpinLockGuard lock(statsLock);
+    return system;
+}
+
+uint32_t Telemetry::lateFrameCount() const {
+    SpinLockGuard lock(statsLock);
+    return lateFrames;
+}
+
+uint32_t Telemetry::skippedFrameCount() const {
+    SpinLockGuard lock(statsLock);
+    return skippedFrames;
+}
+
+uint32_t Telemetry::maxLedCurrent() const {
+    SpinLockGuard lock(statsLock);
+    return ledMa.max();
+}
+
+float Telemetry::framesPerSecond(uint32_t frames, unsigned long since) const {
+    unsigned long elapsed = millis() - since;
+    if (since == 0 || elapsed == 0) return 0;
+    return frames * 1000.0f / elapsed;
+}
+
+float Telemetry::achievedFps() const {
+    uint32_t frames;
+    unsigned long since;
+    {
+        SpinLockGuard lock(statsLock);
+        frames = renderUs.count();
+        since = windowStart;
+    }
+    return framesPerSecond(frames, since);
+}
+
+void Telemetry::startWindow() {
+    renderUs.reset();
+    showUs.reset();
+    ledMa.reset();
+    lateFrames = 0;
+    skippedFrames = 0;
+    windowStart = millis();
+}
+
+void Telemetry::reset() {
+    SpinLockGuard lock(statsLock);
+    startWindow();
+    for (int i = 0; i < SOURCE_COUNT; i++) fetches[i] = FetchStats();
+    wifi = WifiStats();
+}
+
+void Telemetry::printSummary(Print& out) {
+    // Take the window and start the next one in one step, then print
+    HistogramSummary render, show, led;
+    uint32_t late, skipped;
+    unsigned long since;
+    {
+        SpinLockGuard lock(statsLock);
+        render = renderUs.summary();
+        show = showUs.summary();
+        led = ledMa.summary();
+        late = lateFrames;
+        skipped = skippedFrames;
+        since = windowStart;
+        startWindow();
+    }
+
+    out.printf("stats: fps %.1f/%.0f late %lu skip %lu | render %lu/%lu/%luus | show %lu/%lu/%luus",
+               framesPerSecond(render.count, since), targetFps, (unsigned long)late,
+               (unsigned long)skipped, (unsigned long)render.min, (unsigned long)render.average,
+               (unsigned long)render.p99, (unsigned long)show.min, (unsigned long)show.average,
+               (unsigned long)show.p99);
+    out.printf(" | led %lu/%lumA", (unsigned long)led.average, (unsigned long)led.max);
+    for (int i = 0; i < SOURCE_COUNT; i++) {
+        FetchStats f = fetchStats((FetchSource)i);
+        out.printf(" | %s %lu/%lu %lums", SOURCE_NAMES[i], (unsigned long)(f.attempts - f.failures),
+                   (unsigned long)f.failures, (unsigned long)f.latencyMs.average());
+        if (f.lastError != 0) out.printf(" e%d", f.lastError);
+    }
+    WifiStats link = wifiStats();
+    out.printf(" | wifi %lu/%lu lost %lu", (unsigned long)link.connects, (unsigned long)link.attempts,
+               (unsigned long)link.losses);
+    SystemStats health = systemStats();
+    out.printf(" | heap %luk blk %luk frag %u%% | stack %lu/%lu\n",
+               (unsigned long)(health.freeHeap / 1024), (unsigned long)(health.largestFreeBlock / 1024),
+               health.fragmentation(),
+               (unsigned long)health.loopStackFree, (unsigned long)health.networkStackFree);
+}
+
+void Telemetry::printReport(Print& out) const {
+    HistogramSummary render, show, led;
+    uint32_t late, skipped;
+    unsigned long since;
+    {
+        SpinLockGuard lock(statsLock);
+        render = renderUs.summary();
+        show = showUs.summary();
+        led = ledMa.summary();
+        late = lateFrames;
+        skipped = skippedFrames;
+        since = windowStart;
+    }
+
+    out.println("---------------- telemetry ----------------");
+    out.printf("Frames: %lu pushed in window, %.1f fps (target %.0f), %lu late, %lu unchanged\n",
+               (unsigned long)render.count, framesPerSecond(render.count, since), targetFps,
+               (unsigned long)late, (unsigned long)skipped);
+    out.printf("  render us  min %lu  avg %lu  p99 %lu  max %lu\n", (unsigned long)render.min,
+               (unsigned long)render.average, (unsigned long)render.p99, (unsigned long)render.max);
+    out.printf("  show us    min %lu  avg %lu  p99 %lu  max %lu\n", (unsigned long)show.min,
+               (unsigned long)show.average, (unsigned long)show.p99, (unsigned long)show.max);
+    out.printf("  LEDs mA    min %lu  avg %lu  p99 %lu  max %lu (estimated)\n", (unsigned long)led.min,
+               (unsigned long)led.average, (unsigned long)led.p99, (unsigned long)led.max);
+
+    for (int i = 0; i < SOURCE_COUNT; i++) {
+        FetchStats f = fetchStats((FetchSource)i);
+        out.printf("Fetch %-4s: %lu ok, %lu failed, %lu retries, last error %d\n", SOURCE_NAMES[i],
+                   (unsigned long)(f.attempts - f.failures), (unsigned long)f.failures,
+                   (unsigned long)f.retries, f.lastError);
+        out.printf("  latency ms min %lu  avg %lu  p99 %lu  max %lu\n",
+                   (unsigned long)f.latencyMs.min(), (unsigned long)f.latencyMs.average(),
+                   (unsigned long)f.latencyMs.percentile(99), (unsigned long)f.latencyMs.max());
+        out.printf("  errors: http %u, parse %u, transport", f.httpErrors, f.parseErrors);
+        for (int code = 1; code < 12; code++) {
+            if (f.transportErrors[code]) out.printf(" %d:%u", -code, f.transportErrors[code]);
+        }
+        if (f.transportErrors[0]) out.printf(" other:%u", f.transportErrors[0]);
+        out.println();
+    }
+
+    WifiStats link = wifiStats();
+    out.printf("WiFi: %lu connects in %lu attempts (%lu failed), %lu links lost, last reason %u\n",
+               (unsigned long)link.connects, (unsigned long)link.attempts, (unsigned long)link.failures,
+               (unsigned long)link.losses, link.lastReason);
+    out.printf("  offline ms min %lu  avg %lu  p99 %lu  max %lu\n",
+               (unsigned long)link.reconnectMs.min(), (unsigned long)link.reconnectMs.average(),
+               (unsigned long)link.reconnectMs.percentile(99), (unsigned long)link.reconnectMs.max());
+
+    SystemStats health = systemStats();
+    out.printf("Heap: %lu free, %lu min free, %lu largest block (lowest %lu), %u%% fragmented\n",
+               (unsigned long)health.freeHeap, (unsigned long)health.minFreeHeap,
+               (unsigned long)health.largestFreeBlock, (unsigned long)health.lowestLargestBlock,
+               health.fragmentation());
+    out.printf("Stack never used: loop %lu, network %lu bytes\n",
+               (unsigned long)health.loopStackFree, (unsigned long)health.networkStackFree);
+    out.printf("Log: %lu lines dropped\n", (unsigned long)logger.dropped());
+    out.println("-------------------------------------------");
+}
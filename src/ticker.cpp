@@ -0,0 +1,143 @@
+#include "ticker.h"
+
+// Weather codes mapping
+const char* getWeatherDescription(int code) {
+    switch(code) {
+        case 0: return "Clear";
+        case 1: case 2: case 3: return "Cloudy";
+        case 45: case 48: return "Foggy";
+        case 51: case 53: case 55: return "Drizzle";
+        case 61: case 63: case 65: return "Rain";
+        case 80: case 81: case 82: return "Rain";
+        default: return "Unknown";
+    }
+}
+
+// Offline, stale or restored from flash
+static const char* statusMarker(const SensorSnapshot& readings, DataStatus status) {
+    if (status == DATA_OFFLINE) return " (offline)";
+    if (status == DATA_STALE) return " (stale)";
+    if (readings.restored) return " (saved)";
+    return "";
+}
+
+// Text of one segment; joined in order they make up the whole ticker
+static void formatSegment(TickerSegment segment, const SensorSnapshot& readings, DataStatus status,
+                          char* out, size_t size) {
+    const char* degree = GLYPH_DEGREE;
+    switch (segment) {
+        case SEGMENT_LOCATION:
+            snprintf(out, size, "Pa Rang Cafe (Alt: %sm) * ", readings.altitude);
+            break;
+        case SEGMENT_TIME:
+            snprintf(out, size, "%s%s * ", readings.localTime, statusMarker(readings, status));
+            break;
+        case SEGMENT_PM:
+            snprintf(out, size, "PM2.5: %s " GLYPH_MICRO "g/m" GLYPH_CUBED ", ", readings.pm25);
+            break;
+        case SEGMENT_TREND:
+            if (readings.pmMeanHour == INT16_MIN) {
+                out[0] = '\0';
+            } else {
+                const char* arrow = readings.pmTrend > 0 ? GLYPH_ARROW_UP
+                                  : readings.pmTrend < 0 ? GLYPH_ARROW_DOWN : GLYPH_ARROW_RIGHT;
+                snprintf(out, size, "1h %.1f, 24h %.1f %s ",
+                         readings.pmMeanHour / 10.0f, readings.pmMeanDay / 10.0f, arrow);
+            }
+            break;
+        case SEGMENT_SPARKLINE:
+            // Only the separator is text; the bars are added when rasterizing
+            snprintf(out, size, readings.pmMeanHour == INT16_MIN ? "" : " * ");
+            break;
+        case SEGMENT_TEMPERATURE:
+            if (readings.temperatureMinDay == INT16_MIN) {
+                snprintf(out, size, "Temp: %s%sC * ", readings.temperature, degree);
+            } else {
+                snprintf(out, size, "Temp: %s%sC (%.1f-%.1f) * ", readings.temperature, degree,
+                         readings.temperatureMinDay / 10.0f, readings.temperatureMaxDay / 10.0f);
+            }
+            break;
+        case SEGMENT_NOW:
+            snprintf(out, size, "Now: %s, %.1f%sC * ",
+                     getWeatherDescription(readings.currentWeatherCode), readings.currentTemp, degree);
+            break;
+        default:
+            snprintf(out, size, "Tomorrow: %s, Min: %.1f%sC, Max: %.1f%sC *",
+                     getWeatherDescription(readings.tomorrowWeatherCode),
+                     readings.tomorrowMinTemp, degree, readings.tomorrowMaxTemp, degree);
+            break;
+    }
+}
+
+// Which readings a segment is built from; changes whenever its text may
+static uint32_t segmentSource(TickerSegment segment, const SensorSnapshot& readings, DataStatus status) {
+    switch (segment) {
+        case SEGMENT_LOCATION:
+        case SEGMENT_PM:
+        case SEGMENT_TREND:
+        case SEGMENT_SPARKLINE:
+            return readings.pmVersion;
+        case SEGMENT_TIME:
+            return (readings.pmVersion << 3) ^ (status << 1) ^ (readings.restored ? 1 : 0);
+        case SEGMENT_TEMPERATURE:
+            return readings.temperatureVersion;
+        default:
+            return readings.weatherVersion;
+    }
+}
+
+// One column per bar, growing up from the bottom row
+static int rasterizeSparkline(const uint8_t* heights, int count, uint8_t* columns) {
+    for (int i = 0; i < count; i++) {
+        uint8_t height = heights[i] > 8 ? 8 : heights[i];
+        columns[i] = (uint8_t)(0xFF << (8 - height));
+    }
+    return count;
+}
+
+// Build the ticker text from the latest readings
+void composeTickerMessage(const SensorSnapshot& readings, char* combinedMsg, size_t size,
+                          DataStatus status) {
+    size_t length = 0;
+    combinedMsg[0] = '\0';
+    for (int i = 0; i < SEGMENT_COUNT && length < size - 1; i++) {
+        formatSegment((TickerSegment)i, readings, status, combinedMsg + length, size - length);
+        length += strlen(combinedMsg + length);
+    }
+}
+
+bool TickerComposer::update(const SensorSnapshot& readings, DataStatus status) {
+    bool changed = false;
+    for (int i = 0; i < SEGMENT_COUNT; i++) {
+        Segment& s = segments[i];
+        uint32_t source = segmentSource((TickerSegment)i, readings, status);
+        if (s.version != 0 && s.source == source) continue;
+
+        formatSegment((TickerSegment)i, readings, status, s.text, sizeof(s.text));
+        if (i == SEGMENT_SPARKLINE && s.text[0] != '\0') {
+            s.width = rasterizeSparkline(readings.pmSparkline, SPARKLINE_COLUMNS, s.columns);
+            s.width += rasterizeText(s.text, s.columns + s.width, sizeof(s.columns) - s.width);
+        } else {
+            s.width = rasterizeText(s.text, s.columns, sizeof(s.columns));
+        }
+        s.source = source;
+        s.version++;
+        changed = true;
+    }
+    if (!changed) return false;
+
+    // Join the cached strips; a segment that doesn't fit is dropped whole
+    stripWidth = 0;
+    size_t length = 0;
+    for (int i = 0; i < SEGMENT_COUNT; i++) {
+        const Segment& s = segments[i];
+        size_t textLength = strlen(s.text);
+        if (stripWidth + s.width > (int)sizeof(strip) || length + textLength >= sizeof(message)) break;
+        memcpy(strip + stripWidth, s.columns, s.width);
+        memcpy(message + length, s.text, textLength);
+        stripWidth += s.width;
+        length += textLength;
+    }
+    message[length] = '\0';
+    return true;
+}
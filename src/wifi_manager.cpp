@@ -0,0 +1,100 @@
+#include "wifi_manager.h"
+#include "telemetry.h"
+#include "logger.h"
+
+WifiManager wifiManager;
+
+// Set from the WiFi event task, consumed by update() on the loop task
+static volatile bool gotIpPending = false;
+static volatile bool disconnectPending = false;
+static volatile uint8_t disconnectReason = 0;
+
+void WifiManager::onEvent(arduino_event_id_t event, arduino_event_info_t info) {
+    if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+        gotIpPending = true;
+    } else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
+        disconnectReason = info.wifi_sta_disconnected.reason;
+        disconnectPending = true;
+    }
+}
+
+void WifiManager::begin(const char* networkSsid, const char* networkPassword) {
+    ssid = networkSsid;
+    password = networkPassword;
+    WiFi.mode(WIFI_STA);
+    WiFi.setAutoReconnect(false);  // Retries are paced here instead
+    WiFi.onEvent(onEvent);
+    offlineSince = millis();
+    startAttempt(offlineSince);
+}
+
+void WifiManager::startAttempt(unsigned long now) {
+    LOG_INFO("WiFi: connecting to %s (attempt %u)", ssid, attempts + 1);
+    state = STATE_CONNECTING;
+    attemptStart = now;
+    attempts++;
+    telemetry.recordWifiAttempt();
+    WiFi.disconnect();
+    WiFi.begin(ssid, password);
+}
+
+// Exponential backoff with equal jitter: half the delay is fixed, half random
+void WifiManager::scheduleRetry(unsigned long now) {
+    unsigned long backoff = WIFI_BACKOFF_MIN;
+    for (uint16_t i = 1; i < failures && backoff < WIFI_BACKOFF_MAX; i++) backoff *= 2;
+    if (backoff > WIFI_BACKOFF_MAX) backoff = WIFI_BACKOFF_MAX;
+    unsigned long wait = backoff / 2 + random(backoff / 2 + 1);
+
+    LOG_INFO("WiFi: retry in %lu ms", wait);
+    state = STATE_BACKOFF;
+    retryAt = now + wait;
+}
+
+WifiEvent WifiManager::update(unsigned long now) {
+    if (ssid == nullptr) return WIFI_EVENT_NONE;
+    WifiEvent result = WIFI_EVENT_NONE;
+
+    // The disconnect() in startAttempt() is reported as ASSOC_LEAVE some
+    // time later; while connecting, that one is not a failed attempt
+    if (disconnectPending) {
+        disconnectPending = false;
+        if (state == STATE_CONNECTED) {
+            LOG_WARN("WiFi: connection lost (reason %u)", disconnectReason);
+            telemetry.recordWifiLost(disconnectReason);
+            offlineSince = now;
+            failures = 0;
+            attempts = 0;
+            scheduleRetry(now);
+            result = WIFI_EVENT_LOST;
+        } else if (state == STATE_CONNECTING && disconnectReason != WIFI_REASON_ASSOC_LEAVE) {
+            LOG_WARN("WiFi: attempt failed (reason %u)", disconnectReason);
+            telemetry.recordWifiFailure(disconnectReason);
+            failures++;
+            scheduleRetry(now);
+        }
+    }
+
+    if (gotIpPending) {
+        gotIpPending = false;
+        if (state != STATE_CONNECTED && WiFi.status() == WL_CONNECTED) {
+            LOG_INFO("WiFi: connected after %u attempt(s), %lu ms offline",
+                     attempts, now - offlineSince);
+            telemetry.recordWifiConnected(now - offlineSince);
+            state = STATE_CONNECTED;
+            failures = 0;
+            attempts = 0;
+            result = everConnected ? WIFI_EVENT_RECONNECTED : WIFI_EVENT_CONNECTED;
+            everConnected = true;
+        }
+    }
+
+    if (state == STATE_CONNECTING && now - attemptStart >= WIFI_CONNECT_TIMEOUT) {
+        LOG_WARN("WiFi: attempt timed out");
+        telemetry.recordWifiFailure(0);
+        failures++;
+        scheduleRetry(now);
+    } else if (state == STATE_BACKOFF && (long)(now - retryAt) >= 0) {
+        startAttempt(now);
+    }
+    return result;
+}
@@ -0,0 +1,70 @@
+// fuseReadings(): median of the stations that agree, outliers by scaled MAD
+#include <unity.h>
+#include "fetch.h"
+#include "settings.h"
+
+void setUp() {}
+void tearDown() {}
+
+void test_no_values() {
+    float result = -1;
+    TEST_ASSERT_EQUAL(0, fuseReadings(nullptr, 0, result));
+    TEST_ASSERT_EQUAL(-1, result);
+}
+
+void test_single_value() {
+    float values[] = {17.5f};
+    float result = 0;
+    TEST_ASSERT_EQUAL(1, fuseReadings(values, 1, result));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 17.5f, result);
+}
+
+void test_even_count_takes_mean_of_middle_pair() {
+    float values[] = {40, 10};
+    float result = 0;
+    TEST_ASSERT_EQUAL(2, fuseReadings(values, 2, result));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 25, result);
+}
+
+void test_spread_within_limit_is_kept() {
+    // MAD 2 -> limit 3 * 1.4826 * 2 = 8.9 around the median 24
+    float values[] = {28, 20, 24, 26, 22};
+    float result = 0;
+    TEST_ASSERT_EQUAL(5, fuseReadings(values, 5, result));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 24, result);
+}
+
+void test_outlier_is_dropped() {
+    // MAD 1 gives a limit below PM_OUTLIER_MIN, so the floor applies
+    float values[] = {12, 100, 10, 13, 11};
+    float result = 0;
+    TEST_ASSERT_EQUAL(4, fuseReadings(values, 5, result));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 11.5f, result);
+}
+
+void test_outliers_on_both_sides() {
+    float values[] = {0.5f, 30, 31, 29, 32, 30, 90};
+    float result = 0;
+    TEST_ASSERT_EQUAL(5, fuseReadings(values, 7, result));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 30, result);
+}
+
+void test_min_limit_keeps_close_values() {
+    // Identical readings give a MAD of 0; PM_OUTLIER_MIN still keeps a near one
+    float values[] = {20, 20, 20, 20 + PM_OUTLIER_MIN - 0.5f};
+    float result = 0;
+    TEST_ASSERT_EQUAL(4, fuseReadings(values, 4, result));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 20, result);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_no_values);
+    RUN_TEST(test_single_value);
+    RUN_TEST(test_even_count_takes_mean_of_middle_pair);
+    RUN_TEST(test_spread_within_limit_is_kept);
+    RUN_TEST(test_outlier_is_dropped);
+    RUN_TEST(test_outliers_on_both_sides);
+    RUN_TEST(test_min_limit_keeps_close_values);
+    return UNITY_END();
+}
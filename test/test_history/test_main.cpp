@@ -0,0 +1,138 @@
+// RollingWindow against a naive scan of the ring, and History edge cases
+#include <unity.h>
+#include <stdlib.h>
+#include "history.h"
+
+#define ROUNDS 5000
+
+// Min, max, sum and count of the newest length slots ending at head
+static void naiveScan(const int16_t* ring, uint8_t head, int length, int16_t& low, int16_t& high,
+                      int32_t& sum, int& count) {
+    low = high = HISTORY_NO_DATA;
+    sum = 0;
+    count = 0;
+    for (int age = 0; age < length; age++) {
+        int16_t value = ring[(head + HISTORY_SLOTS - age) % HISTORY_SLOTS];
+        if (value == HISTORY_NO_DATA) continue;
+        if (low == HISTORY_NO_DATA || value < low) low = value;
+        if (high == HISTORY_NO_DATA || value > high) high = value;
+        sum += value;
+        count++;
+    }
+}
+
+// Random values from a small range, so ties are common, with gaps
+static int16_t randomValue() {
+    if (rand() % 10 == 0) return HISTORY_NO_DATA;
+    return (int16_t)(rand() % 41 - 20) * (rand() % 4 == 0 ? 800 : 1);
+}
+
+template <uint8_t LENGTH>
+static void compareWithNaiveScan(unsigned seed) {
+    srand(seed);
+    static int16_t ring[HISTORY_SLOTS];
+    RollingWindow<LENGTH> window;
+    for (int i = 0; i < HISTORY_SLOTS; i++) ring[i] = HISTORY_NO_DATA;
+
+    uint8_t head = HISTORY_SLOTS - 1;
+    for (int round = 0; round < ROUNDS; round++) {
+        uint8_t position = (head + 1) % HISTORY_SLOTS;
+        window.expire(ring, position);
+        ring[position] = randomValue();
+        head = position;
+        window.add(ring, position);
+
+        int16_t low, high;
+        int32_t sum;
+        int count;
+        naiveScan(ring, head, LENGTH, low, high, sum, count);
+        TEST_ASSERT_EQUAL_INT16(low, window.min(ring));
+        TEST_ASSERT_EQUAL_INT16(high, window.max(ring));
+        TEST_ASSERT_EQUAL(sum, window.sum());
+        TEST_ASSERT_EQUAL(count, window.count());
+    }
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_hour_window_matches_naive_scan() {
+    for (unsigned seed = 1; seed <= 20; seed++) compareWithNaiveScan<HISTORY_SHORT_SLOTS>(seed);
+}
+
+void test_day_window_matches_naive_scan() {
+    for (unsigned seed = 1; seed <= 5; seed++) compareWithNaiveScan<HISTORY_SLOTS>(seed);
+}
+
+void test_history_windows_match_naive_scan() {
+    srand(42);
+    static History history;
+    static int16_t slots[HISTORY_SLOTS];  // Committed slots, mirrored here
+    for (int i = 0; i < HISTORY_SLOTS; i++) slots[i] = HISTORY_NO_DATA;
+    uint8_t head = HISTORY_SLOTS - 1;
+    int16_t pending = HISTORY_NO_DATA;
+
+    // One reading per slot, sometimes a slot without any
+    uint32_t slot = 1000;
+    uint32_t lastSlot = slot;
+    for (int round = 0; round < 1000; round++) {
+        slot += rand() % 8 == 0 ? 2 : 1;
+        int16_t value = randomValue();
+        if (value == HISTORY_NO_DATA) value = 0;
+        history.record(slot * HISTORY_SLOT_SECONDS, value);
+        if (pending != HISTORY_NO_DATA) {
+            head = (head + 1) % HISTORY_SLOTS;
+            slots[head] = pending;
+            if (slot - lastSlot > 1) {
+                head = (head + 1) % HISTORY_SLOTS;
+                slots[head] = HISTORY_NO_DATA;
+            }
+        }
+        pending = value;
+        lastSlot = slot;
+
+        int16_t low, high;
+        int32_t sum;
+        int count;
+        naiveScan(slots, head, HISTORY_SLOTS, low, high, sum, count);
+        if (low == HISTORY_NO_DATA || pending < low) low = pending;
+        if (high == HISTORY_NO_DATA || pending > high) high = pending;
+        HistoryStats day = history.longWindow();
+        TEST_ASSERT_EQUAL_INT16(low, day.min);
+        TEST_ASSERT_EQUAL_INT16(high, day.max);
+    }
+}
+
+void test_zero_timestamp_is_ignored() {
+    History history;
+    history.record(0, 100);
+    TEST_ASSERT_EQUAL_INT16(HISTORY_NO_DATA, history.latest());
+    history.record(5000 * HISTORY_SLOT_SECONDS, 200);
+    history.record(0, 900);
+    TEST_ASSERT_EQUAL_INT16(200, history.latest());
+    TEST_ASSERT_EQUAL_INT16(200, history.shortWindow().max);
+}
+
+void test_sparkline_wider_than_max_is_padded() {
+    History history;
+    for (uint32_t slot = 1; slot <= HISTORY_SLOTS + 1; slot++) {
+        history.record(slot * HISTORY_SLOT_SECONDS, (int16_t)slot);
+    }
+    uint8_t heights[HISTORY_SPARKLINE_MAX + 8];
+    memset(heights, 0xAA, sizeof(heights));
+    history.sparkline(heights, sizeof(heights), 8);
+    TEST_ASSERT_EQUAL(1, heights[0]);
+    TEST_ASSERT_EQUAL(8, heights[HISTORY_SPARKLINE_MAX - 1]);
+    for (size_t c = HISTORY_SPARKLINE_MAX; c < sizeof(heights); c++) TEST_ASSERT_EQUAL(0, heights[c]);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_hour_window_matches_naive_scan);
+    RUN_TEST(test_day_window_matches_naive_scan);
+    RUN_TEST(test_history_windows_match_naive_scan);
+    RUN_TEST(test_zero_timestamp_is_ignored);
+    RUN_TEST(test_sparkline_wider_than_max_is_padded);
+    return UNITY_END();
+}
@@ -0,0 +1,106 @@
+// HttpSession against the simulated server: chunked and Content-Length
+// bodies must come out byte for byte, over fresh and reused connections
+#include <unity.h>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include "http_session.h"
+#include "settings.h"
+#include "sim.h"
+
+#define FIXTURE_PATH "/test/weather"
+
+static std::string expected;
+
+static std::string fixtureFile() {
+    const char* dir = getenv("SIM_FIXTURES");
+    return std::string(dir ? dir : "native/fixtures") + "/weather.json";
+}
+
+static std::string readBody(HttpSession& session) {
+    std::string body;
+    Stream& stream = session.body();
+    int c;
+    while ((c = stream.read()) >= 0) body += (char)c;
+    session.end();
+    return body;
+}
+
+static void fetchAndCompare(size_t chunkSize) {
+    sim::setChunkSize(chunkSize);
+    HttpSession session(API_HOST);
+    session.setTimeout(200);
+    session.setCompression(false);
+    char message[48];
+    snprintf(message, sizeof(message), "chunk size %zu", chunkSize);
+    for (int request = 0; request < 2; request++) {
+        TEST_ASSERT_EQUAL_MESSAGE(200, session.get(FIXTURE_PATH), message);
+        TEST_ASSERT_EQUAL_MESSAGE(request > 0, session.reusedConnection(), message);
+        std::string body = readBody(session);
+        TEST_ASSERT_EQUAL_size_t(expected.size(), body.size());
+        TEST_ASSERT_EQUAL_MESSAGE(0, body.compare(expected), message);
+    }
+}
+
+void setUp() {}
+
+void tearDown() {
+    sim::setChunkSize(0);
+}
+
+void test_content_length_body() {
+    fetchAndCompare(0);
+}
+
+void test_chunked_body_one_byte_chunks() {
+    fetchAndCompare(1);
+}
+
+void test_chunked_body_odd_chunks() {
+    fetchAndCompare(7);
+}
+
+void test_chunked_body_small_chunks() {
+    fetchAndCompare(64);
+}
+
+void test_chunked_body_single_chunk() {
+    fetchAndCompare(expected.size() + 1);
+}
+
+void test_unread_body_is_drained_for_reuse() {
+    sim::setChunkSize(16);
+    HttpSession session(API_HOST);
+    session.setTimeout(200);
+    session.setCompression(false);
+    TEST_ASSERT_EQUAL(200, session.get(FIXTURE_PATH));
+    for (int i = 0; i < 10; i++) session.body().read();
+    session.end();
+    TEST_ASSERT_EQUAL(200, session.get(FIXTURE_PATH));
+    TEST_ASSERT_TRUE(session.reusedConnection());
+    TEST_ASSERT_EQUAL(0, readBody(session).compare(expected));
+}
+
+int main() {
+    FILE* f = fopen(fixtureFile().c_str(), "rb");
+    if (f) {
+        char buffer[4096];
+        size_t n;
+        while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) expected.append(buffer, n);
+        fclose(f);
+    }
+    sim::addFixture(FIXTURE_PATH, fixtureFile().c_str());
+
+    UNITY_BEGIN();
+    if (expected.empty()) {
+        TEST_MESSAGE("Could not read the weather fixture; set SIM_FIXTURES");
+    } else {
+        RUN_TEST(test_content_length_body);
+        RUN_TEST(test_chunked_body_one_byte_chunks);
+        RUN_TEST(test_chunked_body_odd_chunks);
+        RUN_TEST(test_chunked_body_small_chunks);
+        RUN_TEST(test_chunked_body_single_chunk);
+        RUN_TEST(test_unread_body_is_drained_for_reuse);
+    }
+    return UNITY_END();
+}
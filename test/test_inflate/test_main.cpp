@@ -0,0 +1,134 @@
+// InflateStream behind HttpSession: gzip, zlib and raw deflate bodies, with
+// and without chunked framing, must read back as the plain fixture
+#include <unity.h>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include "http_session.h"
+#include "settings.h"
+#include "sim.h"
+
+#define SMALL_PATH "/test/weather"
+#define LARGE_PATH "/test/area"    // Several times the 32 KB window
+
+static std::string smallPlain;
+static std::string largePlain;
+
+static std::string fixtureFile(const char* name) {
+    const char* dir = getenv("SIM_FIXTURES");
+    return std::string(dir ? dir : "native/fixtures") + "/" + name;
+}
+
+static std::string readFile(const std::string& path) {
+    std::string data;
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return data;
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) data.append(buffer, n);
+    fclose(f);
+    return data;
+}
+
+// Fetch path twice over one connection and compare both bodies with expected
+static void fetchAndCompare(const char* path, const std::string& expected, const char* label) {
+    HttpSession session(API_HOST);
+    session.setTimeout(200);
+    for (int request = 0; request < 2; request++) {
+        TEST_ASSERT_EQUAL_MESSAGE(200, session.get(path), label);
+        std::string body;
+        Stream& stream = session.body();
+        int c;
+        while ((c = stream.read()) >= 0) body += (char)c;
+        session.end();
+        TEST_ASSERT_EQUAL_MESSAGE(expected.size(), body.size(), label);
+        TEST_ASSERT_EQUAL_MESSAGE(0, body.compare(expected), label);
+    }
+}
+
+static void fetchBoth(const char* label) {
+    fetchAndCompare(SMALL_PATH, smallPlain, label);
+    fetchAndCompare(LARGE_PATH, largePlain, label);
+}
+
+void setUp() {}
+
+void tearDown() {
+    sim::setGzip(false);
+    sim::setChunkSize(0);
+}
+
+void test_plain() {
+    fetchBoth("plain");
+}
+
+void test_gzip() {
+    sim::setGzip(true);
+    fetchBoth("gzip");
+}
+
+void test_deflate_zlib() {
+    sim::setDeflate(true);
+    fetchBoth("deflate, zlib");
+}
+
+void test_deflate_raw() {
+    sim::setDeflate(true, false);
+    fetchBoth("deflate, raw");
+}
+
+void test_chunked_gzip() {
+    sim::setGzip(true);
+    size_t sizes[] = {1, 7, 255, 256, 257, 4096};
+    for (size_t size : sizes) {
+        sim::setChunkSize(size);
+        char label[32];
+        snprintf(label, sizeof(label), "gzip, %zu byte chunks", size);
+        fetchBoth(label);
+    }
+}
+
+void test_chunked_deflate() {
+    sim::setDeflate(true);
+    sim::setChunkSize(100);
+    fetchBoth("deflate, 100 byte chunks");
+}
+
+// Reading only the start of a compressed body still frees the inflater
+void test_partial_read_releases_inflater() {
+    sim::setGzip(true);
+    HttpSession first(API_HOST);
+    HttpSession second(API_HOST);
+    first.setTimeout(200);
+    second.setTimeout(200);
+    TEST_ASSERT_EQUAL(200, first.get(LARGE_PATH));
+    for (int i = 0; i < 100; i++) first.body().read();
+    first.end();
+    TEST_ASSERT_EQUAL(200, second.get(SMALL_PATH));
+    std::string body;
+    int c;
+    while ((c = second.body().read()) >= 0) body += (char)c;
+    second.end();
+    TEST_ASSERT_EQUAL(0, body.compare(smallPlain));
+}
+
+int main() {
+    smallPlain = readFile(fixtureFile("weather.json"));
+    largePlain = readFile(fixtureFile("area.json"));
+    sim::addFixture(SMALL_PATH, fixtureFile("weather.json").c_str());
+    sim::addFixture(LARGE_PATH, fixtureFile("area.json").c_str());
+
+    UNITY_BEGIN();
+    if (smallPlain.empty() || largePlain.empty()) {
+        TEST_MESSAGE("Could not read the fixtures; set SIM_FIXTURES");
+    } else {
+        RUN_TEST(test_plain);
+        RUN_TEST(test_gzip);
+        RUN_TEST(test_deflate_zlib);
+        RUN_TEST(test_deflate_raw);
+        RUN_TEST(test_chunked_gzip);
+        RUN_TEST(test_chunked_deflate);
+        RUN_TEST(test_partial_read_releases_inflater);
+    }
+    return UNITY_END();
+}
@@ -0,0 +1,130 @@
+// PollScheduler: staggered start, cadence learning, rechecks and error backoff
+#include <unity.h>
+#include "poll_scheduler.h"
+
+#define CADENCE 145000UL
+#define MIN_INTERVAL 1000UL
+#define MAX_INTERVAL 3600000UL
+
+static PollScheduler scheduler;
+static unsigned long start;
+
+void setUp() {
+    scheduler = PollScheduler();
+    start = millis();
+    scheduler.configure(SOURCE_PM, CADENCE, MIN_INTERVAL, MAX_INTERVAL);
+}
+
+void tearDown() {}
+
+// source is not due a millisecond before at, and due at at
+static void assertDueAt(int source, unsigned long at) {
+    TEST_ASSERT_EQUAL(-1, scheduler.nextDue(at - 1));
+    TEST_ASSERT_EQUAL(source, scheduler.nextDue(at));
+}
+
+void test_first_fetches_are_staggered() {
+    scheduler.configure(SOURCE_TEMP, CADENCE, MIN_INTERVAL, MAX_INTERVAL);
+    scheduler.configure(SOURCE_WEATHER, CADENCE, MIN_INTERVAL, MAX_INTERVAL);
+    unsigned long now = start + 5;
+    TEST_ASSERT_EQUAL(SOURCE_PM, scheduler.nextDue(now));
+    scheduler.complete(SOURCE_PM, FETCH_UPDATED, 1000, now);
+    // Nothing else within POLL_SPACING of a fetch, even if it is due
+    TEST_ASSERT_EQUAL(-1, scheduler.nextDue(now + POLL_SPACING - 1));
+    TEST_ASSERT_EQUAL(SOURCE_TEMP, scheduler.nextDue(now + POLL_SPACING));
+}
+
+void test_new_reading_waits_one_cadence() {
+    unsigned long now = start + 10;
+    scheduler.complete(SOURCE_PM, FETCH_UPDATED, 1000, now);
+    assertDueAt(SOURCE_PM, now + CADENCE);
+    TEST_ASSERT_EQUAL(CADENCE, scheduler.cadence(SOURCE_PM));
+}
+
+void test_cadence_follows_upstream_gaps() {
+    unsigned long now = start + 10;
+    scheduler.complete(SOURCE_PM, FETCH_UPDATED, 1000, now);
+    // Upstream published 120 s later: the estimate moves a quarter of the way
+    now += CADENCE;
+    scheduler.complete(SOURCE_PM, FETCH_UPDATED, 1120, now);
+    unsigned long expected = (3 * CADENCE + 120000) / 4;
+    TEST_ASSERT_EQUAL(expected, scheduler.cadence(SOURCE_PM));
+    assertDueAt(SOURCE_PM, now + expected);
+}
+
+void test_missed_readings_only_nudge_cadence() {
+    unsigned long now = start + 10;
+    scheduler.complete(SOURCE_PM, FETCH_UPDATED, 1000, now);
+    // A gap of ten cadences counts as two at most
+    scheduler.complete(SOURCE_PM, FETCH_UPDATED, 1000 + 10 * CADENCE / 1000, now + CADENCE);
+    TEST_ASSERT_EQUAL((3 * CADENCE + 2 * CADENCE) / 4, scheduler.cadence(SOURCE_PM));
+}
+
+void test_unchanged_rechecks_back_off() {
+    unsigned long now = start + 10;
+    scheduler.complete(SOURCE_PM, FETCH_UPDATED, 1000, now);
+    unsigned long recheck = CADENCE / POLL_RECHECK_DIVISOR;
+    for (int miss = 0; miss < 3; miss++) {
+        now += 60000;
+        scheduler.complete(SOURCE_PM, FETCH_UNCHANGED, 0, now);
+        assertDueAt(SOURCE_PM, now + (recheck << miss));
+    }
+    // A new reading resets the recheck delay and keeps the cadence
+    now += 60000;
+    scheduler.complete(SOURCE_PM, FETCH_UPDATED, 1145, now);
+    now += 60000;
+    scheduler.complete(SOURCE_PM, FETCH_UNCHANGED, 0, now);
+    assertDueAt(SOURCE_PM, now + recheck);
+}
+
+void test_errors_back_off_exponentially_up_to_max() {
+    unsigned long now = start + 10;
+    unsigned long delay = POLL_ERROR_BACKOFF;
+    for (int error = 0; error < 12; error++) {
+        scheduler.complete(SOURCE_PM, FETCH_ERROR, 0, now);
+        unsigned long expected = delay < MAX_INTERVAL ? delay : MAX_INTERVAL;
+        assertDueAt(SOURCE_PM, now + expected);
+        now += expected;
+        delay *= 2;
+    }
+    // Success clears the error count
+    scheduler.complete(SOURCE_PM, FETCH_UPDATED, 1000, now);
+    now += CADENCE;
+    scheduler.complete(SOURCE_PM, FETCH_ERROR, 0, now);
+    assertDueAt(SOURCE_PM, now + POLL_ERROR_BACKOFF);
+}
+
+void test_delays_stay_within_limits() {
+    PollScheduler tight;
+    unsigned long now = millis();
+    tight.configure(SOURCE_WEATHER, 900000, 30000, 60000);
+    tight.complete(SOURCE_WEATHER, FETCH_UNCHANGED, 0, now);  // 900 s / 8 -> max 60 s
+    TEST_ASSERT_EQUAL(-1, tight.nextDue(now + 59999));
+    TEST_ASSERT_EQUAL(SOURCE_WEATHER, tight.nextDue(now + 60000));
+    tight.complete(SOURCE_WEATHER, FETCH_ERROR, 0, now);      // 10 s -> min 30 s
+    TEST_ASSERT_EQUAL(-1, tight.nextDue(now + 29999));
+    TEST_ASSERT_EQUAL(SOURCE_WEATHER, tight.nextDue(now + 30000));
+}
+
+void test_parse_timestamp() {
+    TEST_ASSERT_EQUAL(0, parseTimestamp(""));
+    TEST_ASSERT_EQUAL(0, parseTimestamp("not a time"));
+    TEST_ASSERT_EQUAL(0, parseTimestamp("1999-12-31 23:59:59"));
+    TEST_ASSERT_EQUAL(0, parseTimestamp("2000-01-01 00:00:00"));  // The epoch itself
+    TEST_ASSERT_EQUAL(86400 + 3600 + 60 + 1, parseTimestamp("2000-01-02 01:01:01"));
+    // Both upstream formats, across a leap day
+    TEST_ASSERT_EQUAL(parseTimestamp("2024-02-28 10:15:00") + 2 * 86400, parseTimestamp("2024-03-01T10:15"));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_fetches_are_staggered);
+    RUN_TEST(test_new_reading_waits_one_cadence);
+    RUN_TEST(test_cadence_follows_upstream_gaps);
+    RUN_TEST(test_missed_readings_only_nudge_cadence);
+    RUN_TEST(test_unchanged_rechecks_back_off);
+    RUN_TEST(test_errors_back_off_exponentially_up_to_max);
+    RUN_TEST(test_delays_stay_within_limits);
+    RUN_TEST(test_parse_timestamp);
+    return UNITY_END();
+}
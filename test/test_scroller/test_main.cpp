@@ -0,0 +1,75 @@
+// Scroller cadence and FPS cap with a loop that wakes up a little late
+#include <unity.h>
+#include <stdlib.h>
+#include "display.h"
+#include "telemetry.h"
+
+#define STRIP_WIDTH 200
+#define FRAME_MS 20
+
+static Scroller testScroller;
+static uint8_t strip[STRIP_WIDTH];
+
+void setUp() {
+    // Columns that differ from their neighbours, so every shifted frame is new
+    for (int x = 0; x < STRIP_WIDTH; x++) strip[x] = (uint8_t)(x * 37 + 11) | 1;
+    testScroller.setFramePeriod(FRAME_MS);
+    testScroller.setStaticHold(0);
+    testScroller.startColumns(strip, STRIP_WIDTH, CRGB::White);
+    srand(1);
+}
+
+void tearDown() {}
+
+// Tick once per column, each up to maxJitter ms after it is due. Returns
+// how many columns went to the LEDs (pushed, or rendered but unchanged).
+static int scrollColumns(int columns, unsigned long maxJitter) {
+    int drawn = 0;
+    for (int i = 0; i < columns; i++) {
+        unsigned long now = testScroller.nextFrameAt() + (maxJitter ? rand() % (maxJitter + 1) : 0);
+        uint32_t skipped = telemetry.skippedFrameCount();
+        bool pushed = testScroller.tick(now);
+        if (pushed || telemetry.skippedFrameCount() != skipped) drawn++;
+    }
+    return drawn;
+}
+
+void test_cap_at_frame_rate_draws_every_jittered_column() {
+    testScroller.setMaxFps(1000 / FRAME_MS);
+    uint32_t late = telemetry.lateFrameCount();
+    TEST_ASSERT_EQUAL(100, scrollColumns(100, 5));
+    TEST_ASSERT_EQUAL_UINT32(late, telemetry.lateFrameCount());
+}
+
+void test_cap_at_frame_rate_draws_every_punctual_column() {
+    testScroller.setMaxFps(1000 / FRAME_MS);
+    TEST_ASSERT_EQUAL(100, scrollColumns(100, 0));
+}
+
+void test_cap_at_half_rate_draws_every_other_column() {
+    testScroller.setMaxFps(1000 / (2 * FRAME_MS));
+    TEST_ASSERT_EQUAL(50, scrollColumns(100, 5));
+}
+
+void test_no_cap_draws_every_column() {
+    testScroller.setMaxFps(0);
+    TEST_ASSERT_EQUAL(100, scrollColumns(100, 15));
+}
+
+void test_scroll_ends_after_message_and_matrix_width() {
+    testScroller.setMaxFps(1000 / FRAME_MS);
+    scrollColumns(STRIP_WIDTH + MATRIX_WIDTH - 1, 3);
+    TEST_ASSERT_FALSE(testScroller.isIdle());
+    scrollColumns(1, 3);
+    TEST_ASSERT_TRUE(testScroller.isIdle());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_cap_at_frame_rate_draws_every_jittered_column);
+    RUN_TEST(test_cap_at_frame_rate_draws_every_punctual_column);
+    RUN_TEST(test_cap_at_half_rate_draws_every_other_column);
+    RUN_TEST(test_no_cap_draws_every_column);
+    RUN_TEST(test_scroll_ends_after_message_and_matrix_width);
+    return UNITY_END();
+}
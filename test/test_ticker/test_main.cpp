@@ -0,0 +1,64 @@
+// TickerComposer: no segment is cut short, and only changed segments rebuild
+#include <unity.h>
+#include <string.h>
+#include "ticker.h"
+
+static SensorSnapshot readings;
+
+// Every field at its longest: full-width strings, negative two-digit
+// temperatures, an unknown weather code and the longest status marker
+static void fillWorstCase(SensorSnapshot& r) {
+    r = SensorSnapshot();
+    strcpy(r.pm25, "999999.99");
+    strcpy(r.temperature, "-40.00000");
+    strcpy(r.altitude, "9999.9999");
+    strcpy(r.localTime, "2024-12-31 23:59:59");
+    r.currentTemp = -40.5f;
+    r.currentWeatherCode = 99;
+    r.tomorrowMinTemp = -45.5f;
+    r.tomorrowMaxTemp = -40.5f;
+    r.tomorrowWeatherCode = 99;
+    r.restored = true;
+    r.pmMeanHour = -32767;
+    r.pmMeanDay = -32767;
+    r.pmTrend = 1;
+    r.temperatureMinDay = -455;
+    r.temperatureMaxDay = -405;
+    r.pmVersion = r.temperatureVersion = r.weatherVersion = 1;
+}
+
+void setUp() {
+    fillWorstCase(readings);
+}
+
+void tearDown() {}
+
+void test_worst_case_segments_are_not_truncated() {
+    static TickerComposer composer;
+    static char expected[1024];
+    composeTickerMessage(readings, expected, sizeof(expected), DATA_OFFLINE);
+    TEST_ASSERT_LESS_THAN(MAX_MESSAGE_LENGTH, strlen(expected));
+
+    composer.update(readings, DATA_OFFLINE);
+    TEST_ASSERT_EQUAL_STRING(expected, composer.text());
+}
+
+void test_only_changed_segments_rebuild() {
+    static TickerComposer composer;
+    TEST_ASSERT_TRUE(composer.update(readings, DATA_LIVE));
+    TEST_ASSERT_FALSE(composer.update(readings, DATA_LIVE));
+
+    uint32_t pm = composer.segmentVersion(SEGMENT_PM);
+    uint32_t tomorrow = composer.segmentVersion(SEGMENT_TOMORROW);
+    readings.weatherVersion++;
+    TEST_ASSERT_TRUE(composer.update(readings, DATA_LIVE));
+    TEST_ASSERT_EQUAL_UINT32(pm, composer.segmentVersion(SEGMENT_PM));
+    TEST_ASSERT_EQUAL_UINT32(tomorrow + 1, composer.segmentVersion(SEGMENT_TOMORROW));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_worst_case_segments_are_not_truncated);
+    RUN_TEST(test_only_changed_segments_rebuild);
+    return UNITY_END();
+}
@@ -0,0 +1,59 @@
+// WifiManager against the simulated station: connects, losses and the
+// ASSOC_LEAVE that its own disconnect() reports before every attempt
+#include <unity.h>
+#include "wifi_manager.h"
+#include "telemetry.h"
+#include "sim.h"
+
+static WifiManager manager;
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_first_attempt_connects_without_failures() {
+    sim::setWiFiStatus(WL_CONNECTED);
+    uint32_t failures = telemetry.wifiStats().failures;
+    manager.begin("ssid", "password");
+    TEST_ASSERT_EQUAL(WIFI_EVENT_CONNECTED, manager.update(millis()));
+    TEST_ASSERT_TRUE(manager.connected());
+    TEST_ASSERT_EQUAL_UINT32(failures, telemetry.wifiStats().failures);
+}
+
+void test_reconnect_after_loss_is_not_a_failure() {
+    unsigned long now = millis();
+    WifiStats before = telemetry.wifiStats();
+    sim::setWiFiStatus(WL_DISCONNECTED);
+    TEST_ASSERT_EQUAL(WIFI_EVENT_LOST, manager.update(now));
+    TEST_ASSERT_FALSE(manager.connected());
+
+    // The AP is back by the first retry, at most WIFI_BACKOFF_MIN later
+    sim::setWiFiStatus(WL_CONNECTED);
+    manager.update(now + WIFI_BACKOFF_MIN);
+    TEST_ASSERT_EQUAL(WIFI_EVENT_RECONNECTED, manager.update(now + WIFI_BACKOFF_MIN + 1));
+    WifiStats after = telemetry.wifiStats();
+    TEST_ASSERT_EQUAL_UINT32(before.failures, after.failures);
+    TEST_ASSERT_EQUAL_UINT32(before.losses + 1, after.losses);
+    TEST_ASSERT_EQUAL_UINT32(before.attempts + 1, after.attempts);
+}
+
+void test_attempt_times_out_and_backs_off() {
+    unsigned long now = millis();
+    sim::setWiFiStatus(WL_DISCONNECTED);
+    TEST_ASSERT_EQUAL(WIFI_EVENT_LOST, manager.update(now));
+    uint32_t failures = telemetry.wifiStats().failures;
+
+    manager.update(now + WIFI_BACKOFF_MIN);                  // Retry starts, AP still down
+    manager.update(now + WIFI_BACKOFF_MIN + 1);              // Its ASSOC_LEAVE is ignored
+    TEST_ASSERT_EQUAL_UINT32(failures, telemetry.wifiStats().failures);
+    manager.update(now + WIFI_BACKOFF_MIN + WIFI_CONNECT_TIMEOUT);
+    TEST_ASSERT_EQUAL_UINT32(failures + 1, telemetry.wifiStats().failures);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_attempt_connects_without_failures);
+    RUN_TEST(test_reconnect_after_loss_is_not_a_failure);
+    RUN_TEST(test_attempt_times_out_and_backs_off);
+    return UNITY_END();
+}